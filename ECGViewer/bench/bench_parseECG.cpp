@@ -0,0 +1,159 @@
+/**
+ * @file bench_parseECG.cpp
+ * @brief Microbenchmarks for the ECG parser hot paths.
+ *
+ * Minimal self-contained harness (no external benchmark dependency) around
+ * the pure parser core in ParseEcgCore.hpp. Covers:
+ * - parse_double() / parse_double_fast() on representative tokens
+ * - find_eol()-based line skipping (skip_to_eol)
+ * - parse_ecg_bytes() end-to-end on synthetic exports (single and multi
+ *   threaded)
+ * - median_in_place() as used by fs inference
+ *
+ * Reports rows/sec and bytes/sec so parser changes can be compared across
+ * releases. Row counts for the end-to-end runs default to 1M/10M/50M and can
+ * be overridden on the command line:
+ *
+ *     bench_parseECG [rows ...]
+ *
+ * Build with -DECG_BUILD_BENCHMARKS=ON.
+ */
+#include "ParseEcgCore.hpp"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+/// Keep the optimizer from discarding a computed value.
+template <typename T>
+void do_not_optimize(const T &value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Build a synthetic LabChart-style export with @p rows numeric rows.
+ */
+std::string make_synthetic_export(std::size_t rows) {
+    std::string out;
+    out.reserve(rows * 24 + 64);
+    out += "Interval=0.004\n";
+    out += "ChannelTitle=Lead II\n";
+    out += "Range=+/- 2 mV\n";
+
+    char line[64];
+    for (std::size_t i = 0; i < rows; ++i) {
+        const double t = static_cast<double>(i) * 0.004;
+        const double v = std::sin(static_cast<double>(i) * 0.01);
+        const int n = std::snprintf(line, sizeof(line), "%.3f %.6f\n", t, v);
+        out.append(line, static_cast<std::size_t>(n));
+    }
+    return out;
+}
+
+void bench_parse_double(std::size_t iters) {
+    // One permissive-format and one fixed-format token, round-robin.
+    static const char tok_a[] = "-1.234567e-02 ";
+    static const char tok_b[] = "1234.567890 ";
+
+    Clock::time_point t0 = Clock::now();
+    double sink = 0.0;
+    for (std::size_t i = 0; i < iters; ++i) {
+        double out = 0.0;
+        const char *next = nullptr;
+        if (i & 1)
+            parse_double(tok_a, tok_a + sizeof(tok_a) - 1, out, next);
+        else
+            parse_double(tok_b, tok_b + sizeof(tok_b) - 1, out, next);
+        sink += out;
+    }
+    const double dt = seconds_since(t0);
+    do_not_optimize(sink);
+    std::printf("parse_double            %10zu tokens  %8.3f s  %10.0f tokens/s\n",
+                iters, dt, iters / dt);
+
+    t0 = Clock::now();
+    sink = 0.0;
+    std::size_t hits = 0;
+    for (std::size_t i = 0; i < iters; ++i) {
+        double out = 0.0;
+        const char *next = nullptr;
+        if (parse_double_fast(tok_b, tok_b + sizeof(tok_b) - 1, out, next)) ++hits;
+        sink += out;
+    }
+    const double dt_fast = seconds_since(t0);
+    do_not_optimize(sink);
+    std::printf("parse_double_fast       %10zu tokens  %8.3f s  %10.0f tokens/s (%zu hits)\n",
+                iters, dt_fast, iters / dt_fast, hits);
+}
+
+void bench_skip_to_eol(const std::string &buf) {
+    const char *p = buf.data();
+    const char *end = p + buf.size();
+
+    Clock::time_point t0 = Clock::now();
+    std::size_t lines = 0;
+    while (p < end) {
+        p = skip_to_eol(p, end);
+        ++lines;
+    }
+    const double dt = seconds_since(t0);
+    do_not_optimize(lines);
+    std::printf("skip_to_eol             %10zu lines   %8.3f s  %10.1f MB/s\n",
+                lines, dt, buf.size() / dt / 1e6);
+}
+
+void bench_parse_ecg_bytes(const std::string &buf, std::size_t rows, int threads) {
+    Clock::time_point t0 = Clock::now();
+    EcgData data = parse_ecg_bytes(buf.data(), buf.size(), threads);
+    const double dt = seconds_since(t0);
+    do_not_optimize(data.t.size());
+    std::printf("parse_ecg_bytes(%2d thr) %10zu rows    %8.3f s  %10.0f rows/s  %8.1f MB/s\n",
+                threads, rows, dt, data.t.size() / dt, buf.size() / dt / 1e6);
+}
+
+void bench_median_in_place(std::size_t n) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> dist(0.003, 0.005);
+    std::vector<double> dt_series(n);
+    for (double &x : dt_series) x = dist(rng);
+
+    Clock::time_point t0 = Clock::now();
+    const double med = median_in_place(dt_series);
+    const double dt = seconds_since(t0);
+    do_not_optimize(med);
+    std::printf("median_in_place         %10zu elems   %8.3f s  %10.0f elems/s\n",
+                n, dt, n / dt);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    std::vector<std::size_t> row_counts;
+    for (int i = 1; i < argc; ++i)
+        row_counts.push_back(static_cast<std::size_t>(std::strtoull(argv[i], nullptr, 10)));
+    if (row_counts.empty())
+        row_counts = {1'000'000, 10'000'000, 50'000'000};
+
+    bench_parse_double(20'000'000);
+    bench_median_in_place(10'000'000);
+
+    for (std::size_t rows : row_counts) {
+        std::printf("\n-- synthetic export, %zu rows --\n", rows);
+        const std::string buf = make_synthetic_export(rows);
+        bench_skip_to_eol(buf);
+        bench_parse_ecg_bytes(buf, rows, 1);
+        bench_parse_ecg_bytes(buf, rows, 0);
+    }
+
+    return 0;
+}
@@ -0,0 +1,316 @@
+/**
+ * @file bench_viewer.cpp
+ * @brief Headless frame-time benchmarks for the ECGViewer widget.
+ *
+ * Runs the real viewer against Qt's offscreen platform plugin (no display
+ * needed) on synthetic records and drives the interaction paths analysts
+ * actually exercise:
+ * - slider scrubbing via updateWindow()
+ * - zoom cycling via updateWindowLength()
+ * - fiducial drags through the plot mouse handlers
+ *
+ * Per-frame decimation / fiducial / note / replot timings come from the
+ * viewer's own PerfStats counters (the same ones get_perf_stats() exposes to
+ * Python), so numbers here are directly comparable with live sessions. Use
+ * this to validate pyramid-cache, item-pooling and layer changes and to
+ * catch frame-time regressions before a release.
+ *
+ *     bench_viewer [rows ...] [--fid-hz=N] [--notes=N]
+ *
+ * Rows default to 1M/10M/50M; --fid-hz sets fiducial beats per second of
+ * record (5 markers per beat), --notes the total note count. Build with
+ * -DECG_BUILD_BENCHMARKS=ON.
+ */
+#include "ECGViewer.hpp"
+
+#include <QApplication>
+#include <QMouseEvent>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+namespace ECGViewer {
+
+/**
+ * @brief Bench-only access to the viewer's private interaction paths.
+ *
+ * A friend of ECGViewer so the harness can call the same entry points the
+ * slider, zoom buttons and mouse signals use, without widening the class's
+ * public surface.
+ */
+class ViewerBench
+{
+public:
+    static void updateWindow(ECGViewer& v, int startSample) { v.updateWindow(startSample); }
+    static void updateWindowLength(ECGViewer& v, double s) { v.updateWindowLength(s); }
+    static void mousePress(ECGViewer& v, QMouseEvent* e) { v.onPlotMousePress(e); }
+    static void mouseMove(ECGViewer& v, QMouseEvent* e) { v.onPlotMouseMove(e); }
+    static void mouseRelease(ECGViewer& v, QMouseEvent* e) { v.onPlotMouseRelease(e); }
+    static QCustomPlot* plot(ECGViewer& v) { return v.plot_; }
+    static int maxStartSample(const ECGViewer& v) { return v.max_start_sample_; }
+    static bool draggingFiducial(const ECGViewer& v) { return v.draggingFiducial_; }
+};
+
+} // namespace ECGViewer
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+constexpr double kFs = 250.0;
+constexpr double kWindowS = 10.0;
+
+/// Wrap vector storage as a pinned zero-copy SignalView (what the Python
+/// bridge does with NumPy buffers).
+template <typename T>
+ECGViewer::SignalView<T> viewOf(std::shared_ptr<std::vector<T>> storage) {
+    const T* data = storage->data();
+    const int n = static_cast<int>(storage->size());
+    return ECGViewer::SignalView<T>(data, n, std::move(storage));
+}
+
+struct SyntheticRecord {
+    ECGViewer::TimeAxis t;
+    ECGViewer::SignalView<double> vOrig;
+    ECGViewer::SignalView<double> vClean;
+    ECGViewer::SignalView<unsigned char> mask;
+    QVector<double> fidTimes[5]; // P Q R S T
+    QVector<double> fidVals[5];
+    QVector<ECGViewer::Note> notes;
+};
+
+/**
+ * @brief Build an ECG-shaped record: fs=250, one beat per second, a noise
+ * burst every 30 s, @p fidHz beats' worth of P/Q/R/S/T markers per second
+ * and @p noteCount notes spread across the record (every third one a region).
+ */
+SyntheticRecord make_synthetic_record(int rows, double fidHz, int noteCount) {
+    SyntheticRecord rec;
+
+    auto v = std::make_shared<std::vector<double>>(static_cast<std::size_t>(rows));
+    auto vc = std::make_shared<std::vector<double>>(static_cast<std::size_t>(rows));
+    auto m = std::make_shared<std::vector<unsigned char>>(static_cast<std::size_t>(rows), 0);
+
+    for (int i = 0; i < rows; ++i) {
+        const double tSec = static_cast<double>(i) / kFs;
+        const double phase = tSec - std::floor(tSec);
+        // Narrow peak once per second over a slow baseline wobble.
+        const double qrs = std::exp(-std::pow((phase - 0.5) * 40.0, 2.0));
+        const double base = 0.08 * std::sin(tSec * 0.7);
+        (*vc)[static_cast<std::size_t>(i)] = base + qrs;
+        (*v)[static_cast<std::size_t>(i)] = base + qrs + 0.02 * std::sin(tSec * 321.0);
+    }
+
+    // One 2-second artifact run every 30 seconds.
+    for (int s = 0; s + static_cast<int>(2 * kFs) < rows; s += static_cast<int>(30 * kFs)) {
+        for (int i = s; i < s + static_cast<int>(2 * kFs); ++i)
+            (*m)[static_cast<std::size_t>(i)] = 1;
+    }
+
+    rec.t.makeUniform(0.0, kFs, rows);
+    rec.vOrig = viewOf(std::move(v));
+    rec.vClean = viewOf(std::move(vc));
+    rec.mask = viewOf(std::move(m));
+
+    const double totalS = rows / kFs;
+    static const double offsets[5] = {0.34, 0.46, 0.50, 0.54, 0.68}; // P Q R S T
+    const double beatStep = 1.0 / std::max(fidHz, 1e-6);
+    for (double beat = 0.0; beat + 1.0 <= totalS; beat += beatStep) {
+        for (int k = 0; k < 5; ++k) {
+            const double tFid = beat + offsets[k];
+            rec.fidTimes[k].push_back(tFid);
+            rec.fidVals[k].push_back(k == 2 ? 1.0 : 0.1);
+        }
+    }
+
+    for (int i = 0; i < noteCount; ++i) {
+        ECGViewer::Note n;
+        n.tag = QStringLiteral("bench");
+        n.detail = QStringLiteral("synthetic note %1").arg(i);
+        n.time = (i + 0.5) * totalS / std::max(noteCount, 1);
+        n.duration = (i % 3 == 0) ? 1.5 : 0.0;
+        n.volts = 0.5;
+        rec.notes.push_back(n);
+    }
+
+    return rec;
+}
+
+/// Run queued work (coalesced replots, timers) so each step renders a frame.
+void pump() {
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents();
+}
+
+void bench_scrub(ECGViewer::ECGViewer& viewer, int steps) {
+    const int maxStart = ECGViewer::ViewerBench::maxStartSample(viewer);
+
+    const Clock::time_point t0 = Clock::now();
+    for (int k = 0; k < steps; ++k) {
+        const int start = static_cast<int>(
+            static_cast<double>(k) * maxStart / std::max(steps - 1, 1));
+        ECGViewer::ViewerBench::updateWindow(viewer, start);
+        pump();
+    }
+    const double dt = seconds_since(t0);
+    std::printf("scrub                   %10d frames  %8.3f s  %10.1f frames/s\n",
+                steps, dt, steps / dt);
+}
+
+void bench_zoom(ECGViewer::ECGViewer& viewer, int cycles) {
+    static const double lengths[] = {5.0, 2.0, 1.0, 2.0, 5.0, 10.0, 30.0, 10.0};
+    const int steps = cycles * static_cast<int>(sizeof(lengths) / sizeof(lengths[0]));
+
+    const Clock::time_point t0 = Clock::now();
+    int done = 0;
+    for (int c = 0; c < cycles; ++c) {
+        for (double len : lengths) {
+            ECGViewer::ViewerBench::updateWindowLength(viewer, len);
+            pump();
+            ++done;
+        }
+    }
+    const double dt = seconds_since(t0);
+    std::printf("zoom                    %10d frames  %8.3f s  %10.1f frames/s\n",
+                done, dt, steps / dt);
+}
+
+void bench_fiducial_drag(ECGViewer::ECGViewer& viewer, const SyntheticRecord& rec, int moves) {
+    if (rec.fidTimes[2].isEmpty()) {
+        std::printf("fiducial drag           skipped (no fiducials)\n");
+        return;
+    }
+
+    // Jump to the start and grab the first visible R marker.
+    ECGViewer::ViewerBench::updateWindow(viewer, 0);
+    pump();
+
+    QCustomPlot* plot = ECGViewer::ViewerBench::plot(viewer);
+    const double rTime = rec.fidTimes[2].first();
+    const QPointF pos(plot->xAxis->coordToPixel(rTime),
+                      plot->axisRect()->rect().center().y());
+
+    QMouseEvent press(QEvent::MouseButtonPress, pos,
+                      Qt::LeftButton, Qt::LeftButton, Qt::NoModifier);
+    ECGViewer::ViewerBench::mousePress(viewer, &press);
+    if (!ECGViewer::ViewerBench::draggingFiducial(viewer)) {
+        std::printf("fiducial drag           skipped (marker not hit at %.0f,%.0f)\n",
+                    pos.x(), pos.y());
+        return;
+    }
+
+    const Clock::time_point t0 = Clock::now();
+    QPointF p = pos;
+    for (int k = 0; k < moves; ++k) {
+        p.rx() += (k < moves / 2) ? 2.0 : -2.0;
+        QMouseEvent move(QEvent::MouseMove, p,
+                         Qt::NoButton, Qt::LeftButton, Qt::NoModifier);
+        ECGViewer::ViewerBench::mouseMove(viewer, &move);
+        pump();
+    }
+    const double dt = seconds_since(t0);
+
+    QMouseEvent release(QEvent::MouseButtonRelease, p,
+                        Qt::LeftButton, Qt::NoButton, Qt::NoModifier);
+    ECGViewer::ViewerBench::mouseRelease(viewer, &release);
+    pump();
+
+    std::printf("fiducial drag           %10d frames  %8.3f s  %10.1f frames/s\n",
+                moves, dt, moves / dt);
+}
+
+void print_perf_stats() {
+    std::printf("%-28s %8s %9s %9s %9s %9s\n",
+                "counter", "count", "mean", "p50", "p95", "max");
+    for (const auto& entry : ECGViewer::PerfStats::instance().snapshot()) {
+        const auto& s = entry.second;
+        std::printf("%-28s %8zu %9.3f %9.3f %9.3f %9.3f\n",
+                    entry.first.c_str(), s.count, s.mean, s.p50, s.p95, s.max);
+    }
+}
+
+void run_record(int rows, double fidHz, int noteCount) {
+    std::printf("\n-- synthetic record, %d samples (%.0f s), fid %.1f Hz, %d notes --\n",
+                rows, rows / kFs, fidHz, noteCount);
+
+    SyntheticRecord rec = make_synthetic_record(rows, fidHz, noteCount);
+
+    auto* viewer = new ECGViewer::ECGViewer(
+        rec.t, rec.vOrig, rec.vClean, rec.mask,
+        kFs, kWindowS,
+        false, 0.0, 0.0,
+        false,  // hide_artifacts
+        false,  // colour_blind_mode
+        false,  // quantize
+        false,  // use_opengl
+        rec.fidTimes[0], rec.fidVals[0],
+        QVector<double>(), QVector<double>(),   // Ps
+        QVector<double>(), QVector<double>(),   // Pe
+        rec.fidTimes[1], rec.fidVals[1],
+        rec.fidTimes[2], rec.fidVals[2],
+        rec.fidTimes[3], rec.fidVals[3],
+        rec.fidTimes[4], rec.fidVals[4],
+        QVector<double>(), QVector<double>(),   // Ts
+        QVector<double>(), QVector<double>(),   // Te
+        QStringLiteral("bench_viewer"));
+
+    viewer->resize(1280, 720);
+    viewer->restoreSession(rec.notes, 0.0);
+    viewer->show();
+    pump();
+
+    // Construction and first paint are done; measure interaction only.
+    ECGViewer::PerfStats::instance().reset();
+
+    bench_scrub(*viewer, 100);
+    bench_zoom(*viewer, 5);
+    bench_fiducial_drag(*viewer, rec, 60);
+
+    print_perf_stats();
+
+    delete viewer;
+    pump();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    // Render offscreen unless the caller picked a platform explicitly, so
+    // the harness runs on CI boxes and over ssh without a display.
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+
+    std::vector<int> rowCounts;
+    double fidHz = 1.0;
+    int noteCount = 200;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--fid-hz=", 9) == 0) {
+            fidHz = std::atof(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--notes=", 8) == 0) {
+            noteCount = std::atoi(argv[i] + 8);
+        } else {
+            const long v = std::atol(argv[i]);
+            if (v > 0)
+                rowCounts.push_back(static_cast<int>(v));
+        }
+    }
+    if (rowCounts.empty())
+        rowCounts = {1000000, 10000000, 50000000};
+
+    for (int rows : rowCounts)
+        run_record(rows, fidHz, noteCount);
+
+    return 0;
+}
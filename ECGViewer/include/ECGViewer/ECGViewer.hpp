@@ -12,7 +12,11 @@
  * - Point notes and time-region notes with persistence
  *
  * Design notes:
- * - The viewer owns all signal data (QVector copies) for lifetime safety.
+ * - Large signal arrays (t, original/cleaned voltages) are held as zero-copy
+ *   SignalView references whose backing buffer the viewer pins for its
+ *   lifetime; the artifact byte mask is compacted into run-length segments at
+ *   construction; small fiducial arrays the UI mutates are copied into
+ *   QVectors as before.
  * - Rendering is windowed and downsampled for responsiveness.
  * - User interactions (mouse/keyboard) directly mutate backing vectors
  *   and then update plot items incrementally.
@@ -21,6 +25,7 @@
  *     * Plot/window updates    -> ECGViewerPlot.cpp
  *     * Mouse/keyboard logic   -> ECGViewerInteractions.cpp
  *     * Notes & persistence   -> ECGViewerAnnotations.cpp
+ *     * Full-record export     -> ECGViewerExport.cpp
  *
  * This header intentionally contains minimal inline documentation; detailed
  * behavior is documented alongside implementations in the corresponding
@@ -37,8 +42,23 @@
 #include <QSlider>
 #include <QKeyEvent>
 #include <QMouseEvent>
+#include <QTimer>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
 #include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "qcustomplot.h"
 
@@ -55,6 +75,277 @@ class QListWidgetItem;
 
 namespace ECGViewer {
 
+/**
+ * @brief Read-only, shared view over a contiguous signal array.
+ *
+ * Wraps a raw pointer plus an opaque owner handle that pins the backing
+ * buffer (a NumPy array, a mapped file, a QVector, ...) for the lifetime of
+ * the view. This lets the viewer read 50M-sample records in place instead of
+ * copying them into QVectors at construction.
+ */
+template <typename T>
+class SignalView
+{
+public:
+    SignalView() = default;
+
+    SignalView(const T* data, int size, std::shared_ptr<const void> owner)
+        : data_(data), size_(size), owner_(std::move(owner)) {}
+
+    /// Copying constructor for callers that only have a QVector; the view
+    /// owns the copied storage.
+    explicit SignalView(const QVector<T>& v)
+    {
+        auto storage = std::make_shared<QVector<T>>(v);
+        data_ = storage->constData();
+        size_ = storage->size();
+        owner_ = std::move(storage);
+    }
+
+    int size() const { return size_; }
+    bool isEmpty() const { return size_ == 0; }
+    const T* data() const { return data_; }
+    const T& operator[](int i) const { return data_[i]; }
+    T first() const { return data_[0]; }
+    T last() const { return data_[size_ - 1]; }
+
+private:
+    const T* data_ = nullptr;
+    int size_ = 0;
+    std::shared_ptr<const void> owner_;
+};
+
+/**
+ * @brief Voltage storage: a zero-copy float64 view or int16 quantized samples.
+ *
+ * ECG samples are 12-16 bit ADC data, so quantized mode stores them as int16
+ * plus a per-array scale/offset with no visible precision loss, cutting
+ * per-sample memory from 8 bytes to 2. Access dequantizes with one
+ * multiply-add, and the smaller working set makes window scans faster for
+ * large records. The default mode keeps the original zero-copy view.
+ */
+class SignalStore
+{
+public:
+    SignalStore() = default;
+
+    /// Keep the float64 view as-is (zero-copy mode).
+    void adopt(SignalView<double> view)
+    {
+        view_ = std::move(view);
+        quantized_.clear();
+        isQuantized_ = false;
+    }
+
+    /// Copy into int16 with scale/offset spanning the record's range; the
+    /// source view is released afterwards.
+    void quantizeFrom(const SignalView<double>& view)
+    {
+        const int n = view.size();
+        quantized_.resize(static_cast<std::size_t>(std::max(0, n)));
+
+        double lo = 0.0, hi = 0.0;
+        if (n > 0) {
+            lo = hi = view[0];
+            for (int i = 1; i < n; ++i) {
+                lo = std::min(lo, view[i]);
+                hi = std::max(hi, view[i]);
+            }
+        }
+
+        offset_ = 0.5 * (lo + hi);
+        scale_ = (hi > lo) ? (hi - lo) / 65534.0 : 1.0;
+        const double inv = 1.0 / scale_;
+
+        for (int i = 0; i < n; ++i) {
+            const double q = (view[i] - offset_) * inv;
+            quantized_[static_cast<std::size_t>(i)] = static_cast<std::int16_t>(
+                std::lround(std::max(-32767.0, std::min(32767.0, q))));
+        }
+
+        view_ = SignalView<double>();
+        isQuantized_ = true;
+    }
+
+    int size() const
+    {
+        return isQuantized_ ? static_cast<int>(quantized_.size()) : view_.size();
+    }
+
+    bool isEmpty() const { return size() == 0; }
+    bool isQuantized() const { return isQuantized_; }
+
+    double operator[](int i) const
+    {
+        return isQuantized_
+            ? offset_ + scale_ * static_cast<double>(
+                                     quantized_[static_cast<std::size_t>(i)])
+            : view_[i];
+    }
+
+private:
+    SignalView<double> view_;
+    std::vector<std::int16_t> quantized_;
+    double scale_ = 1.0;
+    double offset_ = 0.0;
+    bool isQuantized_ = false;
+};
+
+/**
+ * @brief Time storage: an explicit float64 view or an implicit uniform axis.
+ *
+ * When the source header provides the sampling interval, timestamps are fully
+ * determined by t0 + i/fs. Uniform mode stores just those two scalars and
+ * computes timestamps arithmetically on access, eliminating the 8-bytes-per-
+ * sample time array entirely; explicit mode keeps the zero-copy view for
+ * records with irregular or resampled time columns.
+ */
+class TimeAxis
+{
+public:
+    TimeAxis() = default;
+
+    /// Explicit mode: keep the float64 view as-is.
+    void adopt(SignalView<double> view)
+    {
+        view_ = std::move(view);
+        uniform_ = false;
+    }
+
+    /// Uniform mode: timestamps are t0 + i/fs for n samples.
+    void makeUniform(double t0, double fs, int n)
+    {
+        t0_ = t0;
+        dt_ = 1.0 / fs;
+        n_ = n;
+        uniform_ = true;
+        view_ = SignalView<double>();
+    }
+
+    int size() const { return uniform_ ? n_ : view_.size(); }
+    bool isEmpty() const { return size() == 0; }
+    bool isUniform() const { return uniform_; }
+
+    double operator[](int i) const
+    {
+        return uniform_ ? t0_ + dt_ * static_cast<double>(i) : view_[i];
+    }
+
+    double first() const { return (*this)[0]; }
+    double last() const { return (*this)[size() - 1]; }
+
+private:
+    SignalView<double> view_;
+    double t0_ = 0.0;
+    double dt_ = 0.0;
+    int n_ = 0;
+    bool uniform_ = false;
+};
+
+/**
+ * @brief Run-length encoded artifact mask: sorted, disjoint [start, end) runs.
+ *
+ * Real masks are a few hundred contiguous artifact stretches, not per-sample
+ * noise, so storing runs instead of one byte per sample drops the mask's
+ * memory to near zero for long records and lets window decimation split the
+ * clean vs noise traces per segment instead of branching on every sample.
+ * Built once at construction from the caller's byte mask, which is released
+ * afterwards.
+ */
+class ArtifactRuns
+{
+public:
+    struct Run
+    {
+        int start = 0;
+        int end = 0; // exclusive
+    };
+
+    void build(const SignalView<unsigned char>& mask)
+    {
+        runs_.clear();
+        const int n = mask.size();
+        int i = 0;
+        while (i < n) {
+            while (i < n && mask[i] == 0) ++i;
+            if (i >= n) break;
+            const int s = i;
+            while (i < n && mask[i] != 0) ++i;
+            runs_.push_back({s, i});
+        }
+        runs_.shrink_to_fit();
+    }
+
+    int count() const { return static_cast<int>(runs_.size()); }
+    bool empty() const { return runs_.empty(); }
+    const Run& operator[](int i) const { return runs_[static_cast<std::size_t>(i)]; }
+
+    /// Index of the first run with end > sample: the run containing @p sample
+    /// if one does, otherwise the next run after it (count() if none).
+    int firstRunAfter(int sample) const
+    {
+        int lo = 0, hi = count();
+        while (lo < hi) {
+            const int mid = lo + (hi - lo) / 2;
+            if (runs_[static_cast<std::size_t>(mid)].end <= sample)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+
+    /// Point query for scattered lookups outside the sequential window scan.
+    bool isArtifact(int sample) const
+    {
+        const int ri = firstRunAfter(sample);
+        return ri < count() && runs_[static_cast<std::size_t>(ri)].start <= sample;
+    }
+
+private:
+    std::vector<Run> runs_;
+};
+
+/**
+ * @brief Multi-resolution min/max tile cache over a signal.
+ *
+ * Level 0 holds one tile per kBaseTileSamples raw samples; each higher level
+ * merges two tiles of the level below. A tile records the min/max envelope of
+ * its sample range plus whether any sample in the range is flagged as an
+ * artifact, so windowed rendering can pick the level matching the current
+ * decimation step and read O(pixels) tiles instead of re-scanning millions of
+ * raw samples.
+ *
+ * build() is safe to run on a background thread; ready() flips once the whole
+ * pyramid is usable and readers fall back to direct scans until then.
+ */
+class MinMaxPyramid
+{
+public:
+    static constexpr int kBaseTileSamples = 16;
+
+    struct Tile
+    {
+        double minV = 0.0;
+        double maxV = 0.0;
+        unsigned char artifact = 0; // any sample in range flagged
+    };
+
+    void build(const SignalStore& v, const ArtifactRuns* runs);
+
+    bool ready() const { return ready_.load(std::memory_order_acquire); }
+
+    /// Smallest level whose tile width is >= step (clamped to the top level).
+    int levelForStep(int step) const;
+
+    int tileSamples(int level) const { return kBaseTileSamples << level; }
+    const std::vector<Tile>& tiles(int level) const { return levels_[level]; }
+
+private:
+    std::vector<std::vector<Tile>> levels_;
+    std::atomic<bool> ready_{false};
+};
+
 struct Note
 {
     QString tag;
@@ -64,13 +355,183 @@ struct Note
     double volts = 0;
 };
 
+/**
+ * @brief Interval index over the notes list for window-overlap queries.
+ *
+ * Notes sorted by start time, augmented with a running maximum of interval
+ * end times. A query binary-searches for the last start <= x1 and walks
+ * backwards only while the max-end prefix can still reach x0, so per-frame
+ * note lookups cost O(log n + matches) instead of scanning every note.
+ *
+ * The index is rebuilt lazily (on the next query after a mutation); with
+ * thousands of region notes that is still far cheaper than the former
+ * full scan on every window update.
+ */
+class NoteIntervalIndex
+{
+public:
+    void rebuild(const QVector<Note>& notes)
+    {
+        const int n = notes.size();
+        order_.resize(n);
+        for (int i = 0; i < n; ++i) order_[i] = i;
+
+        std::stable_sort(order_.begin(), order_.end(),
+                         [&notes](int a, int b) { return notes[a].time < notes[b].time; });
+
+        starts_.resize(n);
+        prefixMaxEnd_.resize(n);
+        double maxEnd = -std::numeric_limits<double>::infinity();
+        for (int i = 0; i < n; ++i) {
+            const Note& note = notes[order_[i]];
+            starts_[i] = note.time;
+            maxEnd = std::max(maxEnd, note.time + std::max(0.0, note.duration));
+            prefixMaxEnd_[i] = maxEnd;
+        }
+    }
+
+    /// Indices (into the notes list) of notes overlapping [x0, x1],
+    /// in ascending note-index order.
+    QVector<int> query(const QVector<Note>& notes, double x0, double x1) const
+    {
+        QVector<int> out;
+
+        // Last sorted position whose start is <= x1.
+        int hi = static_cast<int>(
+            std::upper_bound(starts_.begin(), starts_.end(), x1) - starts_.begin());
+
+        for (int i = hi - 1; i >= 0; --i) {
+            if (prefixMaxEnd_[i] < x0)
+                break; // nothing earlier can reach the window
+
+            const Note& note = notes[order_[i]];
+            const double end = note.time + std::max(0.0, note.duration);
+            if (end >= x0)
+                out.push_back(order_[i]);
+        }
+
+        std::sort(out.begin(), out.end());
+        return out;
+    }
+
+private:
+    QVector<int> order_;          // note indices sorted by start time
+    QVector<double> starts_;      // start time per sorted position
+    QVector<double> prefixMaxEnd_;// running max of interval ends
+};
+
+/**
+ * @brief Process-wide performance counters behind get_perf_stats().
+ *
+ * Named sample series (frame timings in milliseconds, points per frame, ...)
+ * recorded from the hot paths and summarized on demand as count / mean /
+ * p50 / p95 / max. Recording is a mutex-guarded push_back, cheap enough for
+ * per-frame use; summarization copies the series and is only done when
+ * Python asks for a snapshot.
+ */
+class PerfStats
+{
+public:
+    struct Summary
+    {
+        std::size_t count = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+    };
+
+    static PerfStats& instance()
+    {
+        static PerfStats stats;
+        return stats;
+    }
+
+    void record(const char* name, double value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        series_[name].push_back(value);
+    }
+
+    std::map<std::string, Summary> snapshot() const
+    {
+        std::map<std::string, std::vector<double>> copy;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            copy = series_;
+        }
+
+        std::map<std::string, Summary> out;
+        for (auto& entry : copy) {
+            std::vector<double>& samples = entry.second;
+            if (samples.empty())
+                continue;
+
+            Summary s;
+            s.count = samples.size();
+
+            double sum = 0.0;
+            for (double x : samples) sum += x;
+            s.mean = sum / static_cast<double>(samples.size());
+
+            auto quantile = [&samples](double q) {
+                const std::size_t idx = static_cast<std::size_t>(
+                    q * static_cast<double>(samples.size() - 1));
+                std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+                return samples[idx];
+            };
+            s.p50 = quantile(0.50);
+            s.p95 = quantile(0.95);
+            s.max = *std::max_element(samples.begin(), samples.end());
+
+            out[entry.first] = s;
+        }
+        return out;
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        series_.clear();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::vector<double>> series_;
+};
+
+/// Scoped wall-clock timer recording milliseconds into PerfStats.
+class PerfTimer
+{
+public:
+    explicit PerfTimer(const char* name)
+        : name_(name), start_(std::chrono::steady_clock::now()) {}
+
+    ~PerfTimer()
+    {
+        const auto dt = std::chrono::steady_clock::now() - start_;
+        PerfStats::instance().record(
+            name_, std::chrono::duration<double, std::milli>(dt).count());
+    }
+
+private:
+    const char* name_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+class FiducialLayerPlottable;
+
 class ECGViewer : public QMainWindow
 {
+    friend class FiducialLayerPlottable;
+    friend class ViewerBench; // bench/bench_viewer.cpp drives the private
+                              // window/zoom/mouse paths for frame timing
+
 public:
-    ECGViewer(const QVector<double>& t,
-              const QVector<double>& vOrig,
-              const QVector<double>& vClean,
-              const QVector<unsigned char>& artMask,
+    ECGViewer(TimeAxis t,
+              SignalView<double> vOrig,
+              SignalView<double> vClean,
+              SignalView<unsigned char> artMask,
               double fs,
               double window_s,
               bool has_ylim,
@@ -78,6 +539,8 @@ public:
               double ymax,
               bool hide_artifacts,
               bool colour_blind_mode,
+              bool quantize,
+              bool use_opengl,
               const QVector<double>& pTimes,
               const QVector<double>& pVals,
               const QVector<double>& psTimes,
@@ -99,8 +562,127 @@ public:
               const QString& filePrefix,
               QWidget* parent = nullptr);
 
+    ~ECGViewer() override;
+
     enum class FiducialType { P, Ps, Pe, Q, R, S, T, Ts, Te };
 
+    /**
+     * @brief Single time-sorted store for all fiducial markers.
+     *
+     * Struct-of-arrays (times/vals/type tags) kept sorted by time, replacing
+     * the nine parallel QVector pairs. Window rebuilds become a binary search
+     * for the visible range (O(log n + visible)) instead of a linear pass
+     * over every series, and insertions/moves re-position a single entry.
+     */
+    class FiducialStore
+    {
+    public:
+        int size() const { return times_.size(); }
+
+        double timeAt(int i) const { return times_[i]; }
+        double valAt(int i) const { return vals_[i]; }
+        FiducialType typeAt(int i) const { return types_[i]; }
+
+        /// First index with time >= t.
+        int lowerBound(double t) const
+        {
+            return static_cast<int>(
+                std::lower_bound(times_.begin(), times_.end(), t) - times_.begin());
+        }
+
+        /// One past the last index with time <= t.
+        int upperBound(double t) const
+        {
+            return static_cast<int>(
+                std::upper_bound(times_.begin(), times_.end(), t) - times_.begin());
+        }
+
+        /// Bulk append during construction; call finalize() once afterwards.
+        void load(FiducialType type, const QVector<double>& times, const QVector<double>& vals)
+        {
+            for (int i = 0; i < times.size(); ++i) {
+                times_.push_back(times[i]);
+                vals_.push_back(vals[i]);
+                types_.push_back(type);
+            }
+        }
+
+        /// Sort the loaded entries by time (stable within equal timestamps).
+        void finalize()
+        {
+            QVector<int> order(times_.size());
+            for (int i = 0; i < order.size(); ++i) order[i] = i;
+            std::stable_sort(order.begin(), order.end(),
+                             [this](int a, int b) { return times_[a] < times_[b]; });
+
+            QVector<double> st(times_.size()), sv(times_.size());
+            QVector<FiducialType> sk(times_.size());
+            for (int i = 0; i < order.size(); ++i) {
+                st[i] = times_[order[i]];
+                sv[i] = vals_[order[i]];
+                sk[i] = types_[order[i]];
+            }
+            times_ = std::move(st);
+            vals_ = std::move(sv);
+            types_ = std::move(sk);
+        }
+
+        /// Insert keeping time order; returns the new entry's index.
+        int insert(FiducialType type, double time, double val)
+        {
+            int idx = lowerBound(time);
+            times_.insert(idx, time);
+            vals_.insert(idx, val);
+            types_.insert(idx, type);
+            return idx;
+        }
+
+        void removeAt(int i)
+        {
+            times_.remove(i);
+            vals_.remove(i);
+            types_.remove(i);
+        }
+
+        /// Move one entry to a new time/value, restoring order.
+        /// Returns the entry's index after re-positioning.
+        int setTime(int i, double newTime, double newVal)
+        {
+            FiducialType type = types_[i];
+            removeAt(i);
+            return insert(type, newTime, newVal);
+        }
+
+        /// Extract the (times, vals) series of one type, in time order.
+        /// O(n); intended for bulk scatter-graph rebuilds only.
+        void typeSeries(FiducialType type, QVector<double>& times, QVector<double>& vals) const
+        {
+            times.clear();
+            vals.clear();
+            for (int i = 0; i < times_.size(); ++i) {
+                if (types_[i] == type) {
+                    times.push_back(times_[i]);
+                    vals.push_back(vals_[i]);
+                }
+            }
+        }
+
+    private:
+        QVector<double> times_;
+        QVector<double> vals_;
+        QVector<FiducialType> types_;
+    };
+
+    /**
+     * @brief Restore annotation and view state from a session snapshot.
+     *
+     * Called by show_ecg_session() right after construction: installs the
+     * saved notes, marks the lazy note/hover indices dirty, and jumps the
+     * window back to the saved start position. The signal arrays and
+     * fiducials travel through the normal constructor arguments.
+     */
+    void restoreSession(const QVector<Note>& notes, double viewX0);
+
 protected:
     void keyPressEvent(QKeyEvent* event) override;
 
@@ -158,8 +740,34 @@ private:
     QVector<OverlayVisual> overlays_;
 
     void updateWindow(int startSample);
+    void requestWindow(int startSample);
     void nudge(int deltaSamples);
     void updateFiducialLines(double x0, double x1);
+
+    // Frame-paced window scheduler: slider scrubbing writes the requested
+    // start sample here (latest value wins) and a repeating timer applies at
+    // most one window per tick, so fast valueChanged bursts can never queue
+    // more renders than the frame rate allows. -1 = nothing pending.
+    QTimer* windowUpdateTimer_ = nullptr;
+    int pendingStartSample_ = -1;
+
+    // Decimated graph data for one window, plus the key identifying it.
+    // Computed either synchronously in updateWindow() or speculatively by
+    // the prefetch thread.
+    struct WindowBuffers
+    {
+        int startSample = -1;
+        int windowSamples = 0;
+        bool hideArtifacts = false;
+        QVector<double> txBase, vyBase;
+        QVector<double> txNoise, vyNoise;
+        QVector<double> txOrigFull, vyOrigFull;
+    };
+
+    void computeWindowBuffers(WindowBuffers& buf) const;
+    void schedulePrefetch(int startSample);
+    void prefetchLoop();
+
     void updateWindowLength(double newWindowSeconds);
     void deleteHoveredFiducial();
     void updateNoteItems(double x0, double x1);
@@ -172,6 +780,32 @@ private:
     void onSave();
     double mouseVoltsClamped(QMouseEvent* e) const;
 
+    // Full-record export engine (ECGViewerExport.cpp): background thread,
+    // parallel to_chars CSV formatting plus a .ecgbin binary copy.
+    void exportRecordAsync();
+    void exportRecordBlocking(const QString& csvPath, const QString& binPath);
+
+    // Session snapshot (.ecgsession): one mmap-ready file with the raw signal
+    // arrays, artifact mask, fiducials, notes and view state, written next to
+    // the CSV/.ecgbin exports so show_ecg_session() can reopen the record
+    // without re-parsing or re-annotating. The annotation/view state below is
+    // captured on the GUI thread; the big arrays are streamed by the export
+    // worker, which only reads the immutable stores.
+    struct SessionMeta
+    {
+        QVector<double> fidTimes;
+        QVector<double> fidVals;
+        QVector<unsigned char> fidTypes;
+        QByteArray notesJson;
+        double viewX0 = 0.0;
+        double windowS = 0.0;
+        double yMin = 0.0;
+        double yMax = 0.0;
+        bool hideArtifacts = false;
+    };
+    SessionMeta captureSessionMeta() const;
+    void writeSessionSnapshot(const QString& path, const SessionMeta& meta);
+
     void setOverlayMode(bool enabled);
     void clearOverlays();
     void setOverlaysVisible(bool visible);
@@ -189,6 +823,7 @@ private:
 
     QString fiducialLabel(FiducialType type) const;
     QChar fiducialChar(FiducialType type) const;
+    QColor fiducialColor(FiducialType type) const;
     FiducialType fiducialTypeFromText(const QString& s) const;
 
     QString noteListLine(const Note& n) const;
@@ -200,20 +835,37 @@ private:
 
     QDir ensureDataDir() const;
 
-    QVector<double> t_;
-    QVector<double> vOrig_;
-    QVector<double> vClean_;
-    QVector<unsigned char> artMask_;
-
-    QVector<double> pTimes_, pVals_;
-    QVector<double> psTimes_, psVals_;
-    QVector<double> peTimes_, peVals_;
-    QVector<double> qTimes_, qVals_;
-    QVector<double> rTimes_, rVals_;
-    QVector<double> sTimes_, sVals_;
-    QVector<double> tTimes_, tVals_;
-    QVector<double> tsTimes_, tsVals_;
-    QVector<double> teTimes_, teVals_;
+    TimeAxis t_;
+    SignalStore vOrig_;
+    SignalStore vClean_;
+    ArtifactRuns artRuns_;
+
+    // Min/max tile pyramids over the two traces, built once on a background
+    // thread right after construction; updateWindow() falls back to direct
+    // scans until they are ready.
+    MinMaxPyramid pyramidClean_;
+    MinMaxPyramid pyramidOrig_;
+    std::thread pyramidBuildThread_;
+
+    // Window prefetcher: a worker thread speculatively decimates the windows
+    // adjacent to the current view (and the next zoom levels) into ready
+    // buffers, so slider/arrow navigation is usually a buffer swap + replot
+    // instead of a synchronous scan on the GUI thread. The worker only reads
+    // the immutable SignalViews and pyramids, never Qt state.
+    static constexpr int kPrefetchCacheSize = 8;
+    std::thread prefetchThread_;
+    std::mutex prefetchMutex_;
+    std::condition_variable prefetchCv_;
+    std::vector<WindowBuffers> prefetchTasks_; // keys only; buffers empty
+    std::vector<WindowBuffers> prefetchReady_; // completed, oldest first
+    bool prefetchStop_ = false;
+
+    // Full-record export: one background thread at a time; progress lands on
+    // the status bar via queued invocations.
+    std::thread exportThread_;
+    std::atomic<bool> exportRunning_{false};
+
+    FiducialStore fiducials_;
 
     double fs_;
     double window_s_;
@@ -224,7 +876,7 @@ private:
     bool zoomRectMode_ = false;
     bool blockWindowUpdates_ = false;
     double currentX0{0.0}, currentX1{0.0};
-    int hoverFiducialIndex_ = -1; // index into fiducialsCurrent_ for hover, -1 = none
+    int hoverFiducialIndex_ = -1; // index into fiducials_ for hover, -1 = none
     QString filePrefix_;
     bool creatingRegion_ = false;
     int  creatingNoteIndex_ = -1;
@@ -248,13 +900,6 @@ private:
     double originalStart_ = 0.0;
     double originalEnd_ = 0.0;
 
-    struct FiducialVisual
-    {
-        FiducialType type;
-        int index; // index into pTimes_/qTimes_/...
-        QCPItemLine* line = nullptr;
-        QCPItemText* text = nullptr;
-    };
     struct NoteVisual
     {
         int noteIndex = -1;
@@ -263,52 +908,103 @@ private:
         QCPItemRect* rect = nullptr;   // for region notes
     };
 
-    QVector<FiducialVisual> fiducialsCurrent_;  // items currently visible in window
-
     bool draggingFiducial_ = false;
-    int  activeFiducialIndex_ = -1;
+    int  activeFiducialIndex_ = -1;  // index into fiducials_, -1 = none
     double dragOffsetSeconds_ = 0.0; // click offset from fiducial x
 
     QVector<Note> notes_; // all notes (time, tag, detail, volts)
     QVector<NoteVisual> notesCurrent_; // only notes visible in current window
 
+    // Interval index over notes_, rebuilt lazily after mutations.
+    NoteIntervalIndex notesIndex_;
+    bool notesIndexDirty_ = true;
+
+    inline void markNotesIndexDirty() { notesIndexDirty_ = true; }
+
+    // Pixel-space hit-test index for hover tracking (ECGViewerInteractions.cpp):
+    // visible fiducials and point-note lines bucketed by x pixel, region-note
+    // and overlay rectangles in a flat list (tens of rects at most — a linear
+    // scan beats tree overhead at that size). Rebuilt lazily like the note
+    // index: content mutations mark it dirty, and a probe also rebuilds when
+    // the x-range or axis rect it was built against has changed (zoom,
+    // resize), so mouse-move does an O(1) bucket probe instead of itemAt()'s
+    // walk over every plot item.
+    struct HoverIndex
+    {
+        static constexpr int kBucketPx = 16;
+
+        struct LineEntry { bool isNote; int index; double xPx; };
+        struct RectEntry { bool isNote; int index; QRectF rectPx; };
+
+        std::vector<std::vector<LineEntry>> buckets;
+        std::vector<RectEntry> rects;
+        QRect builtRect;
+        QCPRange builtRange;
+        bool dirty = true;
+    };
+
+    struct HoverHit { int note = -1; int fiducial = -1; int overlay = -1; };
+
+    HoverIndex hoverIndex_;
+    inline void markHoverIndexDirty() { hoverIndex_.dirty = true; }
+    void rebuildHoverIndex();
+    HoverHit probeHover(const QPointF& pos);
+
     int hoverNoteIndex_ = -1; // index into notesCurrent_, -1 = none
     bool draggingNote_ = false;
     int  activeNoteVisualIndex_ = -1;
     double noteDragOffsetSeconds_ = 0.0;
 
-    struct FiducialRefs
-    {
-        QVector<double>* times = nullptr;
-        QVector<double>* vals = nullptr;
-        QCPGraph* graph = nullptr;
-        QString label;
-        QChar ch = '?';
-    };
-
-    // helpers to get the correct vecs/graph/label from a type
-    inline FiducialRefs fiducialRefsFor(FiducialType type)
+    // Scatter graph for a type; Ps/Pe/Ts/Te have line/text items only.
+    inline QCPGraph* graphForType(FiducialType type) const
     {
         switch (type) {
-        case FiducialType::P: return FiducialRefs{ &pTimes_, &pVals_, graphP_, "P", 'P' };
-        case FiducialType::Ps: return FiducialRefs{ &psTimes_, &psVals_, nullptr, "Ps", 'P' };
-        case FiducialType::Pe: return FiducialRefs{ &peTimes_, &peVals_, nullptr, "Pe", 'P' };
-        case FiducialType::Q: return FiducialRefs{ &qTimes_, &qVals_, graphQ_, "Q", 'Q' };
-        case FiducialType::R: return FiducialRefs{ &rTimes_, &rVals_, graphR_, "R", 'R' };
-        case FiducialType::S: return FiducialRefs{ &sTimes_, &sVals_, graphS_, "S", 'S' };
-        case FiducialType::T: return FiducialRefs{ &tTimes_, &tVals_, graphT_, "T", 'T' };
-        case FiducialType::Ts: return FiducialRefs{ &tsTimes_, &tsVals_, nullptr, "Ts", 'T' };
-        case FiducialType::Te: return FiducialRefs{ &teTimes_, &teVals_, nullptr, "Te", 'T' };
+        case FiducialType::P: return graphP_;
+        case FiducialType::Q: return graphQ_;
+        case FiducialType::R: return graphR_;
+        case FiducialType::S: return graphS_;
+        case FiducialType::T: return graphT_;
+        default: return nullptr;
         }
-        throw std::runtime_error("Invalid FiducialType");
     }
 
+    /// Bulk-rebuild the scatter graph of one type from the fiducial store.
+    /// Reserved for bulk changes (initial load); single-marker edits go
+    /// through the incremental helpers below.
     inline void refreshFiducialGraph(FiducialType type)
     {
-        auto r = fiducialRefsFor(type);
-        if (!r.graph || !r.times || !r.vals)
+        QCPGraph* graph = graphForType(type);
+        if (!graph)
             return;
-        r.graph->setData(*r.times, *r.vals);
+
+        QVector<double> times, vals;
+        fiducials_.typeSeries(type, times, vals);
+        graph->setData(times, vals);
+    }
+
+    // Incremental scatter updates: edit the one affected entry of the
+    // graph's sorted data container in place instead of copying the whole
+    // series per mouse event. Keys are the exact stored doubles, so the
+    // remove-by-key lookups hit the intended point.
+    inline void addFiducialPoint(FiducialType type, double t, double v)
+    {
+        if (QCPGraph* graph = graphForType(type))
+            graph->data()->add(QCPGraphData(t, v));
+    }
+
+    inline void removeFiducialPoint(FiducialType type, double t)
+    {
+        if (QCPGraph* graph = graphForType(type))
+            graph->data()->remove(t);
+    }
+
+    inline void moveFiducialPoint(FiducialType type, double oldTime,
+                                  double newTime, double newVal)
+    {
+        if (QCPGraph* graph = graphForType(type)) {
+            graph->data()->remove(oldTime);
+            graph->data()->add(QCPGraphData(newTime, newVal));
+        }
     }
 
     inline double minNoteDurationSeconds() const
@@ -334,6 +1030,21 @@ private:
         plot_->setInteractions(savedInteractions_);
     }
 
+    // Buffered layer holding the scatter graphs, the fiducial layer and all
+    // note/overlay items. Drag handlers repaint just this layer; the heavy
+    // signal traces on the "signals" layer composite from their cached
+    // buffer. Axis ranges never move during an item drag (beginItemDrag
+    // disables iRangeDrag), so the other buffers stay valid.
+    QCPLayer* annotationLayer_ = nullptr;
+
+    inline void replotAnnotationLayer()
+    {
+        if (annotationLayer_)
+            annotationLayer_->replot();
+        else
+            plot_->replot(QCustomPlot::rpQueuedReplot);
+    }
+
     QCP::Interactions savedInteractions_;
     QCustomPlot* plot_;
     QSlider* slider_;
@@ -368,7 +1079,70 @@ private:
     QCPGraph* graphS_;
     QCPGraph* graphT_;
 
-    QVector<QCPAbstractItem*> fiducialItems_;
+    // Single plottable painting every visible fiducial marker + label;
+    // owned by the plot like the graphs above.
+    FiducialLayerPlottable* fidLayer_ = nullptr;
+
+    // Free lists of parked plot items, recycled across window rebuilds so a
+    // slider tick re-positions existing items instead of churning new/delete
+    // through QCustomPlot's item list. The plot retains ownership throughout;
+    // parked items are simply hidden.
+    QVector<QCPItemLine*> lineItemPool_;
+    QVector<QCPItemText*> textItemPool_;
+    QVector<QCPItemRect*> rectItemPool_;
+
+    inline QCPItemLine* acquireLineItem()
+    {
+        QCPItemLine* item = lineItemPool_.isEmpty() ? new QCPItemLine(plot_)
+                                                    : lineItemPool_.takeLast();
+        item->setVisible(true);
+        return item;
+    }
+
+    inline QCPItemText* acquireTextItem()
+    {
+        QCPItemText* item = textItemPool_.isEmpty() ? new QCPItemText(plot_)
+                                                    : textItemPool_.takeLast();
+        item->setVisible(true);
+        return item;
+    }
+
+    inline QCPItemRect* acquireRectItem()
+    {
+        QCPItemRect* item = rectItemPool_.isEmpty() ? new QCPItemRect(plot_)
+                                                    : rectItemPool_.takeLast();
+        item->setVisible(true);
+        return item;
+    }
+
+    inline void releaseLineItem(QCPItemLine* item)
+    {
+        if (!item) return;
+        item->setVisible(false);
+        item->setSelected(false);
+        lineItemPool_.push_back(item);
+    }
+
+    // Texts are shared between fiducial and note visuals, which style them
+    // differently; reset the properties only one of the two sites sets.
+    inline void releaseTextItem(QCPItemText* item)
+    {
+        if (!item) return;
+        item->setVisible(false);
+        item->setSelected(false);
+        item->setRotation(0);
+        item->setBrush(Qt::NoBrush);
+        item->setPadding(QMargins());
+        textItemPool_.push_back(item);
+    }
+
+    inline void releaseRectItem(QCPItemRect* item)
+    {
+        if (!item) return;
+        item->setVisible(false);
+        item->setSelected(false);
+        rectItemPool_.push_back(item);
+    }
 
 private slots:
     void onPlotMousePress(QMouseEvent* event);
@@ -376,7 +1150,7 @@ private slots:
     void onPlotMouseRelease(QMouseEvent* event);
     void onInsertManualFiducial();
     void onPlotMouseDoubleClick(QMouseEvent* event);
-    void updatePoint(FiducialVisual& f, double newTime);
+    int updatePoint(int storeIndex, double newTime);
     void onNewNote();
     void onSaveNotes(const bool guiSave = false);
     void onLoadNotes();
@@ -386,4 +1160,46 @@ private slots:
     void onShowNotesDialog();
 };
 
+/**
+ * @brief One plottable painting every visible fiducial marker and label.
+ *
+ * Replaces the per-marker QCPItemLine/QCPItemText pairs: QCustomPlot walks and
+ * paints items individually, so a dense window (every beat labelled) costs
+ * hundreds of item traversals, pen changes and coordinate transforms per
+ * frame. This layer draws the [lo, hi) slice of the time-sorted fiducial
+ * store in a single paint pass and does its own pixel-space hit testing, so
+ * the drag/hover logic works on store indices instead of item pointers.
+ *
+ * Methods live in ECGViewerPlot.cpp next to the other window-drawing code.
+ */
+class FiducialLayerPlottable : public QCPAbstractPlottable
+{
+public:
+    FiducialLayerPlottable(QCPAxis* keyAxis, QCPAxis* valueAxis, ECGViewer* viewer);
+
+    /// Window of store indices to draw, [lo, hi).
+    void setVisibleRange(int lo, int hi) { lo_ = lo; hi_ = hi; }
+
+    /// Store index of the marker line within selection tolerance of @p pos
+    /// (nearest wins), or -1 if none.
+    int hitTest(const QPointF& pos) const;
+
+    double selectTest(const QPointF& pos, bool onlySelectable,
+                      QVariant* details = nullptr) const override;
+    QCPRange getKeyRange(bool& foundRange,
+                         QCP::SignDomain inSignDomain = QCP::sdBoth) const override;
+    QCPRange getValueRange(bool& foundRange,
+                           QCP::SignDomain inSignDomain = QCP::sdBoth,
+                           const QCPRange& inKeyRange = QCPRange()) const override;
+
+protected:
+    void draw(QCPPainter* painter) override;
+    void drawLegendIcon(QCPPainter* painter, const QRectF& rect) const override;
+
+private:
+    ECGViewer* viewer_;
+    int lo_ = 0;
+    int hi_ = 0;
+};
+
 } // namespace ECGViewer
@@ -4,10 +4,17 @@
  *
  * Exposes a single function `show_ecg_viewer(...)` that:
  * - Validates array shapes (expects 1D arrays).
- * - Copies NumPy arrays into QVector for Qt/QCustomPlot usage.
+ * - Hands the large signal arrays (t, v_orig, v_clean, art_mask) to the viewer
+ *   as zero-copy SignalViews that pin the NumPy buffers for the viewer's
+ *   lifetime; only the small fiducial arrays (which the UI mutates) are copied
+ *   into QVectors.
  * - Reuses an existing QApplication if one already exists (common in Python Qt apps),
  *   otherwise creates a local QApplication and runs the event loop.
  *
+ * Also exposes `show_ecg_session(path)`, which memory-maps a .ecgsession
+ * snapshot saved from the viewer and reopens it directly — signals read in
+ * place from the mapping, annotations and view state restored.
+ *
  * The viewer supports:
  * - Original vs cleaned traces, optional artifact hiding
  * - Artifact mask overlay behavior (viewer-side)
@@ -19,9 +26,24 @@
 #include <pybind11/numpy.h>
 
 #include <QApplication>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QtGlobal>
 #include "ECGViewer.hpp"
 
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 namespace py = pybind11;
 
 /**
@@ -47,17 +69,114 @@ static QVector<T> toQVector1D(py::array_t<T, py::array::c_style | py::array::for
     return v;
 }
 
+/**
+ * @brief Wrap a 1D NumPy array as a zero-copy SignalView.
+ *
+ * The view pins the array (or the forcecast copy pybind made of it) via a
+ * shared owner whose deleter re-acquires the GIL before dropping the Python
+ * reference, so the buffer stays valid for as long as the viewer reads it.
+ *
+ * @throws std::runtime_error if the input array is not 1D.
+ */
+template<typename T>
+static ECGViewer::SignalView<T> toSignalView(
+    py::array_t<T, py::array::c_style | py::array::forcecast> arr,
+    const char* name)
+{
+    py::buffer_info info = arr.request();
+    if (info.ndim != 1) {
+        throw std::runtime_error(std::string(name) + " must be 1D");
+    }
+
+    auto* keep = new py::array_t<T, py::array::c_style | py::array::forcecast>(std::move(arr));
+    std::shared_ptr<const void> owner(
+        static_cast<const void*>(info.ptr),
+        [keep](const void*) {
+            py::gil_scoped_acquire gil;
+            delete keep;
+        });
+
+    return ECGViewer::SignalView<T>(static_cast<const T*>(info.ptr),
+                                    static_cast<int>(info.size),
+                                    std::move(owner));
+}
+
 struct FidPair
 {
     QVector<double> times;
     QVector<double> vals;
 };
 
+// Session snapshot constants, shared with the writer in ECGViewerExport.cpp.
+static constexpr char kEcgSessionMagic[8] = {'E', 'C', 'G', 'S', 'E', 'S', '0', '1'};
+static constexpr std::size_t kEcgSessionHeaderBytes = 4096;
+
+struct MappedSession
+{
+    const unsigned char* base = nullptr;
+    std::size_t size = 0;
+    std::shared_ptr<const void> owner; // keeps the mapping/buffer alive
+};
+
+/**
+ * @brief Map a session snapshot file read-only.
+ *
+ * On POSIX the file is mmap'ed with MADV_WILLNEED so the kernel starts
+ * paging it in immediately — resume cost is the disk read, nothing else.
+ * On Windows (or if mmap fails) the whole file is read into a heap buffer
+ * instead; either way the returned owner pins the bytes for the viewer's
+ * lifetime via the SignalView mechanism.
+ */
+static MappedSession mapSessionFile(const std::string& path)
+{
+    MappedSession out;
+
+#if !defined(_WIN32)
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* base = ::mmap(nullptr, static_cast<std::size_t>(st.st_size),
+                                PROT_READ, MAP_PRIVATE, fd, 0);
+            if (base != MAP_FAILED) {
+                const std::size_t len = static_cast<std::size_t>(st.st_size);
+                ::madvise(base, len, MADV_WILLNEED);
+                ::close(fd);
+                out.base = static_cast<const unsigned char*>(base);
+                out.size = len;
+                out.owner = std::shared_ptr<const void>(
+                    out.base, [base, len](const void*) { ::munmap(base, len); });
+                return out;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in)
+        throw std::runtime_error("cannot open session file: " + path);
+    const std::streamoff len = in.tellg();
+    auto buf = std::make_shared<std::vector<unsigned char>>(
+        static_cast<std::size_t>(std::max<std::streamoff>(len, 0)));
+    in.seekg(0);
+    in.read(reinterpret_cast<char*>(buf->data()),
+            static_cast<std::streamsize>(buf->size()));
+    if (!in)
+        throw std::runtime_error("short read on session file: " + path);
+
+    out.base = buf->data();
+    out.size = buf->size();
+    out.owner = std::move(buf);
+    return out;
+}
+
 /**
  * @brief Launch the ECG viewer window.
  *
  * Inputs:
- * - t: time array (seconds, 1D)
+ * - t: time array (seconds, 1D), or a scalar t0 for an implicit uniform
+ *   time axis (timestamps computed as t0 + i/fs)
  * - v_orig: original ECG samples aligned with t
  * - v_clean: cleaned ECG samples aligned with t
  * - art_mask: 0/1 style byte mask aligned with t
@@ -67,6 +186,13 @@ struct FidPair
  * - hide_artifacts: whether to hide the original trace in the UI
  * - p/q/r/s/t_times + p/q/r/s/t_vals: fiducial marker series (may be empty)
  * - file_prefix: base name for output files saved from the UI
+ * - quantize: store voltages inside the viewer as int16 + scale/offset
+ *   instead of pinning the float64 arrays (4x less memory for large records;
+ *   values are dequantized on access)
+ * - use_opengl: render the plot through QCustomPlot's OpenGL paint buffer.
+ *   Requires the module to be built with -DECG_USE_OPENGL=ON; falls back to
+ *   software rendering (with a warning) otherwise or if no GL context is
+ *   available.
  *
  * Notes:
  * - If no QApplication exists, one is created and exec() is called.
@@ -76,7 +202,7 @@ struct FidPair
  *   Can use a tick box for this option in the gui that launchers the viewer.
  */
 static void show_ecg_viewer(
-    py::array_t<double> t,
+    py::object t,
     py::array_t<double> v_orig,
     py::array_t<double> v_clean,
     py::array_t<unsigned char> art_mask,
@@ -103,13 +229,26 @@ static void show_ecg_viewer(
     py::array_t<double> te_times,
     py::array_t<double> te_vals,
     const py::object& file_prefix,
-    bool colour_blind_mode
+    bool colour_blind_mode,
+    bool quantize,
+    bool use_opengl
 )
 {
-    auto tq = toQVector1D<double>(t, "t");
-    auto vOrigQ = toQVector1D<double>(v_orig, "v_orig");
-    auto vCleanQ = toQVector1D<double>(v_clean, "v_clean");
-    auto artQ = toQVector1D<unsigned char>(art_mask, "art_mask");
+    auto vOrigQ = toSignalView<double>(v_orig, "v_orig");
+    auto vCleanQ = toSignalView<double>(v_clean, "v_clean");
+    auto artQ = toSignalView<unsigned char>(art_mask, "art_mask");
+
+    // t may be a full timestamp array or a scalar t0 (implicit uniform time,
+    // as returned by parse_ecg_file(..., implicit_time=True)); in the scalar
+    // form timestamps are computed as t0 + i/fs and never materialized.
+    ECGViewer::TimeAxis tq;
+    if (py::isinstance<py::float_>(t) || py::isinstance<py::int_>(t)) {
+        if (fs <= 0.0)
+            throw std::runtime_error("scalar t (implicit uniform time) requires fs > 0");
+        tq.makeUniform(py::cast<double>(t), fs, vOrigQ.size());
+    } else {
+        tq.adopt(toSignalView<double>(py::cast<py::array_t<double>>(t), "t"));
+    }
 
     if (tq.size() != vOrigQ.size() ||
         tq.size() != vCleanQ.size() ||
@@ -184,6 +323,8 @@ static void show_ecg_viewer(
         ymax,
         hide_artifacts,
         colour_blind_mode,
+        quantize,
+        use_opengl,
         P.times, P.vals,
         Ps.times, Ps.vals,
         Pe.times, Pe.vals,
@@ -207,6 +348,187 @@ static void show_ecg_viewer(
     }
 }
 
+/**
+ * @brief Reopen a saved session snapshot (.ecgsession) in the viewer.
+ *
+ * Maps the file written by the viewer's Save action and points the viewer's
+ * zero-copy SignalViews straight into the mapping: no text parsing, no array
+ * copies for the signals, no re-running of the Python preprocessing that
+ * produced the original arrays. Fiducials, notes and the saved window
+ * position/zoom are restored, so resume cost is dominated by the disk read.
+ *
+ * colour_blind_mode / quantize / use_opengl mirror the show_ecg_viewer
+ * options; they are display preferences, not part of the saved state.
+ */
+static void show_ecg_session(
+    const std::string& path,
+    bool colour_blind_mode,
+    bool quantize,
+    bool use_opengl
+)
+{
+    MappedSession m = mapSessionFile(path);
+    if (m.size < kEcgSessionHeaderBytes ||
+        std::memcmp(m.base, kEcgSessionMagic, 8) != 0) {
+        throw std::runtime_error(path + " is not an .ecgsession snapshot");
+    }
+
+    auto readU64 = [&m](std::size_t off) {
+        std::uint64_t v;
+        std::memcpy(&v, m.base + off, 8);
+        return v;
+    };
+    auto readF64 = [&m](std::size_t off) {
+        double v;
+        std::memcpy(&v, m.base + off, 8);
+        return v;
+    };
+
+    const std::uint64_t rows = readU64(8);
+    const bool uniformTime = m.base[16] != 0;
+    const bool hideArtifacts = m.base[17] != 0;
+    const double fs = readF64(24);
+    const double t0 = readF64(32);
+    const double viewX0 = readF64(40);
+    const double windowS = readF64(48);
+    const double yMin = readF64(56);
+    const double yMax = readF64(64);
+    const std::uint64_t fidCount = readU64(72);
+    const std::uint64_t noteBytes = readU64(80);
+    const std::uint64_t offT = readU64(88);
+    const std::uint64_t offVOrig = readU64(96);
+    const std::uint64_t offVClean = readU64(104);
+    const std::uint64_t offMask = readU64(112);
+    const std::uint64_t offFidTimes = readU64(120);
+    const std::uint64_t offFidVals = readU64(128);
+    const std::uint64_t offFidTypes = readU64(136);
+    const std::uint64_t offNotes = readU64(144);
+
+    if (rows > static_cast<std::uint64_t>(std::numeric_limits<int>::max()) ||
+        fidCount > static_cast<std::uint64_t>(std::numeric_limits<int>::max()))
+        throw std::runtime_error("session snapshot too large: " + path);
+    if (uniformTime && fs <= 0.0)
+        throw std::runtime_error("session snapshot has uniform time but fs <= 0");
+
+    auto checkRange = [&](std::uint64_t off, std::uint64_t bytes, const char* what) {
+        if (off > m.size || bytes > m.size - off)
+            throw std::runtime_error(std::string("truncated session snapshot (") +
+                                     what + "): " + path);
+    };
+    auto f64View = [&](std::uint64_t off, std::uint64_t count, const char* what) {
+        checkRange(off, count * 8, what);
+        return ECGViewer::SignalView<double>(
+            reinterpret_cast<const double*>(m.base + off),
+            static_cast<int>(count), m.owner);
+    };
+
+    // Signal arrays read in place from the mapping.
+    auto vOrigQ = f64View(offVOrig, rows, "v_orig");
+    auto vCleanQ = f64View(offVClean, rows, "v_clean");
+    checkRange(offMask, rows, "art_mask");
+    ECGViewer::SignalView<unsigned char> artQ(m.base + offMask,
+                                              static_cast<int>(rows), m.owner);
+
+    ECGViewer::TimeAxis tq;
+    if (uniformTime)
+        tq.makeUniform(t0, fs, static_cast<int>(rows));
+    else
+        tq.adopt(f64View(offT, rows, "t"));
+
+    // Fiducials: distribute the flat (time, val, type) arrays back into the
+    // per-type series the constructor takes. These are small and the UI
+    // mutates them, so copying is the right call (same as show_ecg_viewer).
+    checkRange(offFidTimes, fidCount * 8, "fiducial times");
+    checkRange(offFidVals, fidCount * 8, "fiducial values");
+    checkRange(offFidTypes, fidCount, "fiducial types");
+    const double* fidTimes = reinterpret_cast<const double*>(m.base + offFidTimes);
+    const double* fidVals = reinterpret_cast<const double*>(m.base + offFidVals);
+    const unsigned char* fidTypes = m.base + offFidTypes;
+
+    constexpr int kNumFidTypes = 9; // FiducialType::P .. Te
+    FidPair series[kNumFidTypes];
+    for (std::uint64_t i = 0; i < fidCount; ++i) {
+        if (fidTypes[i] >= kNumFidTypes)
+            throw std::runtime_error("session snapshot has unknown fiducial type");
+        series[fidTypes[i]].times.push_back(fidTimes[i]);
+        series[fidTypes[i]].vals.push_back(fidVals[i]);
+    }
+
+    // Notes JSON, same schema as the viewer's notes files.
+    checkRange(offNotes, noteBytes, "notes");
+    QVector<ECGViewer::Note> notes;
+    if (noteBytes > 0) {
+        const QByteArray json(reinterpret_cast<const char*>(m.base + offNotes),
+                              static_cast<int>(noteBytes));
+        QJsonParseError err;
+        const QJsonDocument doc = QJsonDocument::fromJson(json, &err);
+        if (err.error != QJsonParseError::NoError)
+            throw std::runtime_error("session snapshot has invalid notes JSON: " +
+                                     err.errorString().toStdString());
+        for (const auto& v : doc.array()) {
+            const QJsonObject o = v.toObject();
+            ECGViewer::Note n;
+            n.tag = o["tag"].toString();
+            n.detail = o["detail"].toString();
+            n.time = o["time"].toDouble();
+            n.duration = o["duration"].toDouble();
+            n.volts = o["volts"].toDouble();
+            notes.push_back(n);
+        }
+    }
+
+    // <prefix>_session.ecgsession -> <prefix>, so files saved from the
+    // resumed viewer land under the same prefix as the original session.
+    QString filePrefix = QFileInfo(QString::fromStdString(path)).completeBaseName();
+    if (filePrefix.endsWith(QStringLiteral("_session")))
+        filePrefix.chop(QStringLiteral("_session").size());
+    if (filePrefix.isEmpty())
+        filePrefix = QStringLiteral("ecg_data");
+
+    QApplication* app = qobject_cast<QApplication*>(QApplication::instance());
+    bool created_app = false;
+
+    if (!app) {
+        int argc = 0;
+        char* argv[] = { nullptr };
+        app = new QApplication(argc, argv);
+        created_app = true;
+    }
+
+    auto* viewer = new ECGViewer::ECGViewer(
+        tq,
+        vOrigQ,
+        vCleanQ,
+        artQ,
+        fs,
+        windowS,
+        true,
+        yMin,
+        yMax,
+        hideArtifacts,
+        colour_blind_mode,
+        quantize,
+        use_opengl,
+        series[0].times, series[0].vals,
+        series[1].times, series[1].vals,
+        series[2].times, series[2].vals,
+        series[3].times, series[3].vals,
+        series[4].times, series[4].vals,
+        series[5].times, series[5].vals,
+        series[6].times, series[6].vals,
+        series[7].times, series[7].vals,
+        series[8].times, series[8].vals,
+        filePrefix
+    );
+
+    viewer->restoreSession(notes, viewX0);
+    viewer->setAttribute(Qt::WA_DeleteOnClose);
+    viewer->show();
+
+    if (created_app)
+        app->exec();
+}
+
 PYBIND11_MODULE(ECGViewer, m)
 {
     m.doc() = "Qt + QCustomPlot ECG viewer with artifacts, noise replacement, and fiducials";
@@ -238,5 +560,52 @@ PYBIND11_MODULE(ECGViewer, m)
         py::arg("te_times"),
         py::arg("te_vals"),
         py::arg("file_prefix"),
-        py::arg("colour_blind_mode") = false);
+        py::arg("colour_blind_mode") = false,
+        py::arg("quantize") = false,
+        py::arg("use_opengl") = false);
+
+    m.def("show_ecg_session", &show_ecg_session,
+        py::arg("path"),
+        py::arg("colour_blind_mode") = false,
+        py::arg("quantize") = false,
+        py::arg("use_opengl") = false,
+        R"pbdoc(
+Reopen a saved session snapshot (.ecgsession) in the viewer.
+
+The snapshot is written next to the CSV/.ecgbin exports when you press Save
+in the viewer (<prefix>_session.ecgsession under ./ECGData). It contains the
+raw signal arrays, artifact mask, all fiducial series, notes and the window
+position/zoom at save time; the file is memory-mapped and the arrays are
+read in place, so resuming a session is limited by disk speed rather than
+parsing or preprocessing.
+)pbdoc");
+
+    m.def("get_perf_stats",
+        []()
+        {
+            py::dict out;
+            for (const auto& entry : ECGViewer::PerfStats::instance().snapshot()) {
+                py::dict s;
+                s["count"] = entry.second.count;
+                s["mean"] = entry.second.mean;
+                s["p50"] = entry.second.p50;
+                s["p95"] = entry.second.p95;
+                s["max"] = entry.second.max;
+                out[py::str(entry.first)] = s;
+            }
+            return out;
+        },
+        R"pbdoc(
+Snapshot of the viewer's performance counters.
+
+Returns a dict mapping counter name (viewer.frame_ms, viewer.decimate_ms,
+viewer.fiducials_ms, viewer.notes_ms, viewer.replot_ms,
+viewer.points_per_frame, viewer.prefetch_hit) to a dict with count, mean,
+p50, p95 and max over all samples recorded since startup or the last
+reset_perf_stats() call.
+)pbdoc");
+
+    m.def("reset_perf_stats",
+        []() { ECGViewer::PerfStats::instance().reset(); },
+        "Clear all recorded performance counters.");
 }
@@ -68,10 +68,14 @@ QString ECGViewer::fiducialLabel(FiducialType type) const
 {
     switch (type) {
     case FiducialType::P: return "P";
+    case FiducialType::Ps: return "Ps";
+    case FiducialType::Pe: return "Pe";
     case FiducialType::Q: return "Q";
     case FiducialType::R: return "R";
     case FiducialType::S: return "S";
     case FiducialType::T: return "T";
+    case FiducialType::Ts: return "Ts";
+    case FiducialType::Te: return "Te";
     }
     return "?";
 }
@@ -80,14 +84,39 @@ QChar ECGViewer::fiducialChar(FiducialType type) const
 {
     switch (type) {
     case FiducialType::P: return 'P';
+    case FiducialType::Ps: return 'P';
+    case FiducialType::Pe: return 'P';
     case FiducialType::Q: return 'Q';
     case FiducialType::R: return 'R';
     case FiducialType::S: return 'S';
     case FiducialType::T: return 'T';
+    case FiducialType::Ts: return 'T';
+    case FiducialType::Te: return 'T';
     }
     return '?';
 }
 
+QColor ECGViewer::fiducialColor(FiducialType type) const
+{
+    switch (type) {
+    case FiducialType::P:
+    case FiducialType::Ps:
+    case FiducialType::Pe:
+        return useColourBlindPalette_ ? QColor("#56B4E9") : QColor(Qt::blue);
+    case FiducialType::Q:
+        return useColourBlindPalette_ ? QColor("#0072B2") : QColor(Qt::green);
+    case FiducialType::R:
+        return useColourBlindPalette_ ? QColor("#E69F00") : QColor(Qt::red);
+    case FiducialType::S:
+        return useColourBlindPalette_ ? QColor("#CC79A7") : QColor(Qt::magenta);
+    case FiducialType::T:
+    case FiducialType::Ts:
+    case FiducialType::Te:
+        return useColourBlindPalette_ ? QColor("#D55E00") : QColor(255, 140, 0);
+    }
+    return QColor(Qt::black);
+}
+
 ECGViewer::FiducialType ECGViewer::fiducialTypeFromText(const QString& s) const
 {
     if (s == "P") return FiducialType::P;
@@ -135,6 +164,7 @@ int ECGViewer::createNoteAtTime(double relTime)
     n.detail = QString();
     n.duration = 0.0;
     notes_.push_back(n);
+    markNotesIndexDirty();
     return notes_.size() - 1;
 }
 
@@ -164,7 +194,7 @@ QDir ECGViewer::ensureDataDir() const
 /**
  * @brief Insert a fiducial point at the center of the current window.
  * @details Computes the new X as the window midpoint, samples Y from vClean_,
- * inserts into sorted backing vectors, refreshes scatter and re-builds line items.
+ * inserts into the sorted store and adds the single scatter point in place.
  */
 void ECGViewer::onInsertManualFiducial()
 {
@@ -174,18 +204,9 @@ void ECGViewer::onInsertManualFiducial()
     double newTime = clampTime(0.5 * (currentX0 + currentX1));
     double newVal = cleanValueAtTime(newTime);
 
-    auto r = fiducialRefsFor(type);
-    QVector<double>& times = *r.times;
-    QVector<double>& vals = *r.vals;
+    fiducials_.insert(type, newTime, newVal);
 
-    int insertIndex = 0;
-    while (insertIndex < times.size() && times[insertIndex] < newTime)
-        ++insertIndex;
-
-    times.insert(insertIndex, newTime);
-    vals.insert(insertIndex, newVal);
-
-    refreshFiducialGraph(type);
+    addFiducialPoint(type, newTime, newVal);
 
     updateFiducialLines(currentX0, currentX1);
     plot_->replot();
@@ -259,6 +280,7 @@ void ECGViewer::openNoteEditor(int noteIndex)
         n.detail = detailEdit->toPlainText();
 
         clampNoteToBounds(n);
+        markNotesIndexDirty();
 
         updateNoteItems(currentX0, currentX1);
         plot_->replot();
@@ -276,6 +298,7 @@ void ECGViewer::deleteHoveredNote()
         return;
 
     notes_.remove(noteIndex);
+    markNotesIndexDirty();
 
     updateNoteItems(currentX0, currentX1);
     plot_->replot();
@@ -368,6 +391,7 @@ void ECGViewer::onDeleteNoteFromList()
         return;
 
     notes_.remove(noteIndex);
+    markNotesIndexDirty();
 
     updateNoteItems(currentX0, currentX1);
     refreshNotesList();
@@ -486,17 +510,43 @@ void ECGViewer::onSave()
     };
 
     for (const auto& type : types) {
-        auto r = fiducialRefsFor(type);
-        QVector<double>& vals = *r.vals;
-        QVector<double>& times = *r.times;
-
         QChar tagChar = fiducialChar(type);
-        for (int i = 0; i < times.size(); ++i) {
-            out << tagChar << "," << times[i] << "," << vals[i] << "\n";
+        for (int i = 0; i < fiducials_.size(); ++i) {
+            if (fiducials_.typeAt(i) != type)
+                continue;
+            out << tagChar << "," << fiducials_.timeAt(i) << "," << fiducials_.valAt(i) << "\n";
         }
     }
 
     file.close();
+
+    // The full record (time/original/cleaned/artifact) goes through the
+    // background export engine, which also writes the .ecgsession snapshot
+    // for show_ecg_session(); the GUI stays responsive while it writes.
+    exportRecordAsync();
+}
+
+/**
+ * @brief Restore annotation and view state from a session snapshot.
+ * @details Called by show_ecg_session() right after construction. The saved
+ * notes replace the (empty) list of a fresh viewer, the lazy note/hover
+ * indices are marked dirty so the next frame rebuilds them, and the window
+ * jumps to the saved start so the viewer reopens exactly where the session
+ * left off.
+ */
+void ECGViewer::restoreSession(const QVector<Note>& notes, double viewX0)
+{
+    notes_ = notes;
+    markNotesIndexDirty();
+    markHoverIndexDirty();
+    refreshNotesList();
+
+    const double t0 = t_.isEmpty() ? 0.0 : t_.first();
+    int startSample = static_cast<int>((viewX0 - t0) * fs_ + 0.5);
+    startSample = std::max(0, std::min(startSample, max_start_sample_));
+
+    slider_->setValue(startSample);
+    updateWindow(startSample);
 }
 
 void ECGViewer::onLoadNotes()
@@ -569,6 +619,7 @@ void ECGViewer::onLoadNotes()
     }
 
     notes_ = loaded;
+    markNotesIndexDirty();
 
     updateNoteItems(currentX0, currentX1);
     refreshNotesList();
@@ -680,6 +731,7 @@ void ECGViewer::onShowNotesDialog()
             return;
 
         notes_.remove(idx);
+        markNotesIndexDirty();
         updateNoteItems(currentX0, currentX1);
         plot_->replot();
         refreshList();
@@ -0,0 +1,409 @@
+/**
+ * @file ECGViewerExport.cpp
+ * @brief Fast full-record export engine for ECGViewer.
+ *
+ * Exports the whole loaded record (time, original, cleaned, artifact flag)
+ * off the GUI thread:
+ * - CSV: doubles are formatted with std::to_chars (shortest round-trip form)
+ *   into large per-chunk buffers; chunks are formatted in parallel across
+ *   worker threads and written to disk in order.
+ * - Binary: a .ecgbin file in the parseECG sidecar layout (4 KB header, then
+ *   raw little-endian float64 t and cleaned-v arrays), written at disk speed.
+ * - Session: a .ecgsession snapshot (signals, artifact mask, fiducials,
+ *   notes, view state) that show_ecg_session() can mmap and reopen directly.
+ *
+ * Progress is reported by queueing status-bar updates onto the GUI thread;
+ * the small fiducial/notes exports in ECGViewerAnnotations.cpp are unchanged.
+ */
+
+#include "ECGViewer.hpp"
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStatusBar>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__cpp_lib_to_chars)
+#include <charconv>
+#endif
+
+namespace ECGViewer {
+
+namespace {
+
+/**
+ * @brief Format one double into @p buf, returning the byte count.
+ *
+ * std::to_chars emits the shortest representation that round-trips, with no
+ * locale machinery; the snprintf fallback covers toolchains without
+ * floating-point to_chars.
+ */
+int formatDouble(char* buf, int cap, double v)
+{
+#if defined(__cpp_lib_to_chars)
+    auto res = std::to_chars(buf, buf + cap, v);
+    if (res.ec == std::errc())
+        return static_cast<int>(res.ptr - buf);
+#endif
+    return std::snprintf(buf, static_cast<std::size_t>(cap), "%.17g", v);
+}
+
+// Binary header layout shared with the parseECG .ecgbin sidecar. The source
+// size/mtime fields are written as zero: this file is a standalone export,
+// not a cache entry validated against a text source.
+constexpr char kEcgBinMagic[8] = {'E', 'C', 'G', 'B', 'I', 'N', '0', '1'};
+constexpr std::size_t kEcgBinHeaderBytes = 4096;
+
+// Session snapshot layout (.ecgsession): same 4 KB header convention as
+// .ecgbin, followed by 8-byte-aligned raw little-endian arrays so a loader
+// can mmap the file and point SignalViews straight into it. Fixed header
+// fields:
+//   0   magic "ECGSES01"
+//   8   u64  rows
+//   16  u8   uniform time axis (t array omitted; timestamps are t0 + i/fs)
+//   17  u8   hide_artifacts
+//   24  f64  fs
+//   32  f64  t0
+//   40  f64  view x0 (left edge of the visible window, s)
+//   48  f64  window length (s)
+//   56  f64  y-axis min
+//   64  f64  y-axis max
+//   72  u64  fiducial count
+//   80  u64  notes JSON byte count
+//   88  u64  offsets: t, vOrig, vClean, mask, fidTimes, fidVals, fidTypes,
+//             notes (eight fields, 88..151; t offset is 0 in uniform mode)
+constexpr char kEcgSessionMagic[8] = {'E', 'C', 'G', 'S', 'E', 'S', '0', '1'};
+constexpr std::size_t kEcgSessionHeaderBytes = 4096;
+
+std::uint64_t alignUp8(std::uint64_t off)
+{
+    return (off + 7) & ~std::uint64_t(7);
+}
+
+} // namespace
+
+/**
+ * @brief Worker body: write the full record as .ecgbin and CSV.
+ *
+ * Runs on exportThread_. Timestamps and voltages are materialized through
+ * TimeAxis/SignalStore operator[], so uniform time axes and quantized storage
+ * export identically to their zero-copy counterparts.
+ */
+void ECGViewer::exportRecordBlocking(const QString& csvPath, const QString& binPath)
+{
+    const int n = t_.size();
+
+    auto postStatus = [this](const QString& msg) {
+        QMetaObject::invokeMethod(this, [this, msg]() {
+            statusBar()->showMessage(msg, 5000);
+        }, Qt::QueuedConnection);
+    };
+
+    // --- Binary export: header + raw float64 t and cleaned-v arrays. ---
+    {
+        std::FILE* f = std::fopen(binPath.toLocal8Bit().constData(), "wb");
+        if (!f) {
+            postStatus(QStringLiteral("Export failed: cannot write %1").arg(binPath));
+            exportRunning_.store(false);
+            return;
+        }
+
+        std::vector<char> header(kEcgBinHeaderBytes, 0);
+        const uint64_t rows = static_cast<uint64_t>(n);
+        const uint8_t hasFs = 1;
+        const uint8_t hasInterval = fs_ > 0.0 ? 1 : 0;
+        const double interval = fs_ > 0.0 ? 1.0 / fs_ : 0.0;
+        std::memcpy(header.data(), kEcgBinMagic, 8);
+        std::memcpy(header.data() + 8, &rows, 8);
+        std::memcpy(header.data() + 32, &hasFs, 1);
+        std::memcpy(header.data() + 33, &hasInterval, 1);
+        std::memcpy(header.data() + 48, &fs_, 8);
+        std::memcpy(header.data() + 56, &interval, 8);
+        std::fwrite(header.data(), 1, header.size(), f);
+
+        // Stream through a reusable buffer so uniform/quantized storage never
+        // materializes the full arrays.
+        constexpr int kBinChunk = 1 << 20;
+        std::vector<double> buf(static_cast<std::size_t>(std::min(n, kBinChunk)));
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int s0 = 0; s0 < n; s0 += kBinChunk) {
+                const int s1 = std::min(s0 + kBinChunk, n);
+                for (int i = s0; i < s1; ++i)
+                    buf[static_cast<std::size_t>(i - s0)] =
+                        pass == 0 ? t_[i] : vClean_[i];
+                std::fwrite(buf.data(), sizeof(double),
+                            static_cast<std::size_t>(s1 - s0), f);
+            }
+        }
+        std::fclose(f);
+    }
+
+    // --- CSV export: parallel chunk formatting, ordered writes. ---
+    std::FILE* f = std::fopen(csvPath.toLocal8Bit().constData(), "wb");
+    if (!f) {
+        postStatus(QStringLiteral("Export failed: cannot write %1").arg(csvPath));
+        exportRunning_.store(false);
+        return;
+    }
+
+    static const char kCsvHeader[] = "Time,Original,Cleaned,Artifact\n";
+    std::fwrite(kCsvHeader, 1, sizeof(kCsvHeader) - 1, f);
+
+    constexpr int kChunkRows = 1 << 19;
+    const int nChunks = (n + kChunkRows - 1) / kChunkRows;
+
+    unsigned nWorkers = std::thread::hardware_concurrency();
+    if (nWorkers == 0) nWorkers = 1;
+    nWorkers = std::min<unsigned>(nWorkers, static_cast<unsigned>(nChunks));
+
+    // Format one chunk of rows into its own buffer; rows are independent so
+    // chunks parallelize freely, and writing them back in chunk order keeps
+    // the output identical to a sequential pass.
+    auto formatChunk = [this](int c, std::vector<char>& out) {
+        const int s0 = c * kChunkRows;
+        const int s1 = std::min(s0 + kChunkRows, t_.size());
+        out.clear();
+        out.reserve(static_cast<std::size_t>(s1 - s0) * 48);
+
+        char num[64];
+        for (int i = s0; i < s1; ++i) {
+            int len = formatDouble(num, sizeof(num), t_[i]);
+            out.insert(out.end(), num, num + len);
+            out.push_back(',');
+            len = formatDouble(num, sizeof(num), vOrig_[i]);
+            out.insert(out.end(), num, num + len);
+            out.push_back(',');
+            len = formatDouble(num, sizeof(num), vClean_[i]);
+            out.insert(out.end(), num, num + len);
+            out.push_back(',');
+            out.push_back(artRuns_.isArtifact(i) ? '1' : '0');
+            out.push_back('\n');
+        }
+    };
+
+    std::vector<std::vector<char>> buffers(nWorkers);
+
+    for (int batch = 0; batch < nChunks; batch += static_cast<int>(nWorkers)) {
+        const int batchEnd = std::min(batch + static_cast<int>(nWorkers), nChunks);
+
+        std::vector<std::thread> workers;
+        workers.reserve(static_cast<std::size_t>(batchEnd - batch));
+        for (int c = batch; c < batchEnd; ++c)
+            workers.emplace_back([&, c]() { formatChunk(c, buffers[c - batch]); });
+        for (auto& w : workers) w.join();
+
+        for (int c = batch; c < batchEnd; ++c)
+            std::fwrite(buffers[c - batch].data(), 1, buffers[c - batch].size(), f);
+
+        const int pct = static_cast<int>(100.0 * batchEnd / nChunks);
+        postStatus(QStringLiteral("Exporting record... %1%").arg(pct));
+    }
+
+    std::fclose(f);
+
+    postStatus(QStringLiteral("Export finished: %1").arg(csvPath));
+    exportRunning_.store(false);
+}
+
+/**
+ * @brief Snapshot the mutable annotation and view state for the session file.
+ *
+ * Runs on the GUI thread before the export worker starts: fiducials, notes
+ * (serialized to compact JSON here so the worker never touches Qt JSON types
+ * concurrently with the UI) and the current window position/zoom. The big
+ * signal arrays are not copied; the worker streams them from the immutable
+ * stores.
+ */
+ECGViewer::SessionMeta ECGViewer::captureSessionMeta() const
+{
+    SessionMeta meta;
+
+    meta.fidTimes.reserve(fiducials_.size());
+    meta.fidVals.reserve(fiducials_.size());
+    meta.fidTypes.reserve(fiducials_.size());
+    for (int i = 0; i < fiducials_.size(); ++i) {
+        meta.fidTimes.push_back(fiducials_.timeAt(i));
+        meta.fidVals.push_back(fiducials_.valAt(i));
+        meta.fidTypes.push_back(static_cast<unsigned char>(fiducials_.typeAt(i)));
+    }
+
+    QJsonArray arr;
+    for (const auto& n : notes_) {
+        QJsonObject o;
+        o["tag"] = n.tag;
+        o["detail"] = n.detail;
+        o["time"] = n.time;
+        o["duration"] = n.duration;
+        o["volts"] = n.volts;
+        arr.append(o);
+    }
+    meta.notesJson = QJsonDocument(arr).toJson(QJsonDocument::Compact);
+
+    meta.viewX0 = currentX0;
+    meta.windowS = window_s_;
+    meta.yMin = y_min_orig_;
+    meta.yMax = y_max_orig_;
+    meta.hideArtifacts = hide_artifacts_;
+    return meta;
+}
+
+/**
+ * @brief Worker body: write the session snapshot file.
+ *
+ * Streams the time/original/cleaned arrays through a reusable chunk buffer
+ * (uniform time axes are elided entirely — the header's t0/fs reproduces
+ * them), regenerates the per-sample artifact mask from the run-length store,
+ * and appends the captured fiducials, notes JSON and view state. Every array
+ * starts on an 8-byte boundary so the loader can mmap the file and read the
+ * doubles in place.
+ */
+void ECGViewer::writeSessionSnapshot(const QString& path, const SessionMeta& meta)
+{
+    const int n = t_.size();
+    const std::uint64_t rows = static_cast<std::uint64_t>(n);
+    const std::uint64_t fidCount = static_cast<std::uint64_t>(meta.fidTimes.size());
+    const std::uint64_t noteBytes = static_cast<std::uint64_t>(meta.notesJson.size());
+    const bool uniformTime = t_.isUniform();
+
+    // Section offsets, laid out back to back with 8-byte alignment.
+    std::uint64_t off = kEcgSessionHeaderBytes;
+    const std::uint64_t offT = uniformTime ? 0 : off;
+    if (!uniformTime) off += rows * 8;
+    const std::uint64_t offVOrig = off;  off += rows * 8;
+    const std::uint64_t offVClean = off; off += rows * 8;
+    const std::uint64_t offMask = off;   off = alignUp8(off + rows);
+    const std::uint64_t offFidTimes = off; off += fidCount * 8;
+    const std::uint64_t offFidVals = off;  off += fidCount * 8;
+    const std::uint64_t offFidTypes = off; off = alignUp8(off + fidCount);
+    const std::uint64_t offNotes = off;
+
+    std::FILE* f = std::fopen(path.toLocal8Bit().constData(), "wb");
+    if (!f) {
+        QMetaObject::invokeMethod(this, [this, path]() {
+            statusBar()->showMessage(
+                QStringLiteral("Session snapshot failed: cannot write %1").arg(path), 5000);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    {
+        std::vector<char> header(kEcgSessionHeaderBytes, 0);
+        const std::uint8_t uniform = uniformTime ? 1 : 0;
+        const std::uint8_t hideArt = meta.hideArtifacts ? 1 : 0;
+        const double t0 = n > 0 ? t_.first() : 0.0;
+        std::memcpy(header.data(), kEcgSessionMagic, 8);
+        std::memcpy(header.data() + 8, &rows, 8);
+        std::memcpy(header.data() + 16, &uniform, 1);
+        std::memcpy(header.data() + 17, &hideArt, 1);
+        std::memcpy(header.data() + 24, &fs_, 8);
+        std::memcpy(header.data() + 32, &t0, 8);
+        std::memcpy(header.data() + 40, &meta.viewX0, 8);
+        std::memcpy(header.data() + 48, &meta.windowS, 8);
+        std::memcpy(header.data() + 56, &meta.yMin, 8);
+        std::memcpy(header.data() + 64, &meta.yMax, 8);
+        std::memcpy(header.data() + 72, &fidCount, 8);
+        std::memcpy(header.data() + 80, &noteBytes, 8);
+        const std::uint64_t offsets[8] = {
+            offT, offVOrig, offVClean, offMask,
+            offFidTimes, offFidVals, offFidTypes, offNotes
+        };
+        std::memcpy(header.data() + 88, offsets, sizeof(offsets));
+        std::fwrite(header.data(), 1, header.size(), f);
+    }
+
+    // Signal arrays, streamed so uniform/quantized storage never materializes
+    // the full record. Pass 0 (time) is skipped for uniform axes.
+    constexpr int kChunk = 1 << 20;
+    {
+        std::vector<double> buf(static_cast<std::size_t>(std::min(n, kChunk)));
+        for (int pass = uniformTime ? 1 : 0; pass < 3; ++pass) {
+            for (int s0 = 0; s0 < n; s0 += kChunk) {
+                const int s1 = std::min(s0 + kChunk, n);
+                for (int i = s0; i < s1; ++i)
+                    buf[static_cast<std::size_t>(i - s0)] =
+                        pass == 0 ? t_[i] : (pass == 1 ? vOrig_[i] : vClean_[i]);
+                std::fwrite(buf.data(), sizeof(double),
+                            static_cast<std::size_t>(s1 - s0), f);
+            }
+        }
+    }
+
+    // Artifact mask, regenerated one chunk at a time from the run store.
+    {
+        std::vector<unsigned char> mbuf(static_cast<std::size_t>(std::min(n, kChunk)));
+        int run = 0;
+        for (int s0 = 0; s0 < n; s0 += kChunk) {
+            const int s1 = std::min(s0 + kChunk, n);
+            std::fill(mbuf.begin(), mbuf.begin() + (s1 - s0), 0);
+            while (run < artRuns_.count() && artRuns_[run].end <= s0)
+                ++run;
+            for (int r = run; r < artRuns_.count() && artRuns_[r].start < s1; ++r) {
+                const int a = std::max(artRuns_[r].start, s0);
+                const int b = std::min(artRuns_[r].end, s1);
+                std::fill(mbuf.begin() + (a - s0), mbuf.begin() + (b - s0), 1);
+            }
+            std::fwrite(mbuf.data(), 1, static_cast<std::size_t>(s1 - s0), f);
+        }
+        const std::uint64_t pad = offFidTimes - (offMask + rows);
+        const char zeros[8] = {0};
+        std::fwrite(zeros, 1, static_cast<std::size_t>(pad), f);
+    }
+
+    // Fiducials, notes, trailing alignment padding.
+    std::fwrite(meta.fidTimes.constData(), sizeof(double),
+                static_cast<std::size_t>(fidCount), f);
+    std::fwrite(meta.fidVals.constData(), sizeof(double),
+                static_cast<std::size_t>(fidCount), f);
+    std::fwrite(meta.fidTypes.constData(), 1, static_cast<std::size_t>(fidCount), f);
+    {
+        const std::uint64_t pad = offNotes - (offFidTypes + fidCount);
+        const char zeros[8] = {0};
+        std::fwrite(zeros, 1, static_cast<std::size_t>(pad), f);
+    }
+    std::fwrite(meta.notesJson.constData(), 1, static_cast<std::size_t>(noteBytes), f);
+
+    std::fclose(f);
+}
+
+/**
+ * @brief Start a full-record export in the background.
+ *
+ * Writes ./ECGData/<prefix>_ecg_signal.csv and .ecgbin plus the
+ * <prefix>_session.ecgsession snapshot. Ignores the request (with a status
+ * message) if an export is already running; the previous thread handle is
+ * joined before reuse, which is immediate once the running flag has cleared.
+ */
+void ECGViewer::exportRecordAsync()
+{
+    if (exportRunning_.exchange(true)) {
+        statusBar()->showMessage(QStringLiteral("An export is already running."), 3000);
+        return;
+    }
+
+    if (exportThread_.joinable())
+        exportThread_.join();
+
+    QDir dir = ensureDataDir();
+    const QString csvPath = dir.filePath(QString("%1_ecg_signal.csv").arg(filePrefix_));
+    const QString binPath = dir.filePath(QString("%1_ecg_signal.ecgbin").arg(filePrefix_));
+    const QString sessionPath = dir.filePath(QString("%1_session.ecgsession").arg(filePrefix_));
+
+    // Capture the mutable annotation/view state before leaving the GUI
+    // thread; the worker writes the snapshot first so a fast resume is
+    // available even while the slower CSV export is still running.
+    SessionMeta meta = captureSessionMeta();
+
+    statusBar()->showMessage(QStringLiteral("Exporting record..."));
+    exportThread_ = std::thread([this, csvPath, binPath, sessionPath,
+                                 meta = std::move(meta)]() {
+        writeSessionSnapshot(sessionPath, meta);
+        exportRecordBlocking(csvPath, binPath);
+    });
+}
+
+} // namespace ECGViewer
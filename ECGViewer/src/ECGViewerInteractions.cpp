@@ -23,22 +23,14 @@ namespace ECGViewer {
 
 void ECGViewer::deleteHoveredFiducial()
 {
-    if (hoverFiducialIndex_ < 0 || hoverFiducialIndex_ >= fiducialsCurrent_.size())
+    if (hoverFiducialIndex_ < 0 || hoverFiducialIndex_ >= fiducials_.size())
         return;
 
-    const auto f = fiducialsCurrent_[hoverFiducialIndex_];
+    const FiducialType type = fiducials_.typeAt(hoverFiducialIndex_);
+    const double t = fiducials_.timeAt(hoverFiducialIndex_);
+    fiducials_.removeAt(hoverFiducialIndex_);
 
-    auto r = fiducialRefsFor(f.type);
-    QVector<double>& times = *r.times;
-    QVector<double>& vals = *r.vals;
-
-    if (f.index < 0 || f.index >= times.size())
-        return;
-
-    times.remove(f.index);
-    vals.remove(f.index);
-
-    refreshFiducialGraph(f.type);
+    removeFiducialPoint(type, t);
 
     updateFiducialLines(currentX0, currentX1);
 
@@ -105,7 +97,7 @@ void ECGViewer::onPlotMousePress(QMouseEvent* event)
             updateOverlayRubberBand(overlayAnchorX_, overlayAnchorX_);
             beginItemDrag(Qt::CrossCursor);
 
-            plot_->replot(QCustomPlot::rpQueuedReplot);
+            replotAnnotationLayer();
             return;
         }
     }
@@ -174,6 +166,7 @@ void ECGViewer::onPlotMousePress(QMouseEvent* event)
         n.volts = cleanValueAtTime(n.time);
 
         notes_.push_back(n);
+        markNotesIndexDirty();
         creatingNoteIndex_ = notes_.size() - 1;
 
         updateNoteItems(currentX0, currentX1);
@@ -186,20 +179,19 @@ void ECGViewer::onPlotMousePress(QMouseEvent* event)
 
         beginItemDrag(Qt::CrossCursor);
 
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         noteDragMode_ = NoteDragMode::CreateRegion;
         return;
     }
 
-    for (int i = 0; i < fiducialsCurrent_.size(); ++i) {
-        auto& f = fiducialsCurrent_[i];
-        if (f.line == item || f.text == item) {
+    if (fidLayer_) {
+        const int storeIdx = fidLayer_->hitTest(event->pos());
+        if (storeIdx >= 0) {
             draggingFiducial_ = true;
-            activeFiducialIndex_ = i;
+            activeFiducialIndex_ = storeIdx;
 
             double clickX = plot_->xAxis->pixelToCoord(event->pos().x());
-            auto r = fiducialRefsFor(f.type);
-            double currentX = (*r.times)[f.index];
+            double currentX = fiducials_.timeAt(storeIdx);
             dragOffsetSeconds_ = currentX - clickX;
 
             beginItemDrag(Qt::ClosedHandCursor);
@@ -228,6 +220,134 @@ void ECGViewer::onPlotMousePress(QMouseEvent* event)
 
 }
 
+/**
+ * @brief Rebuild the pixel-space hover index for the current view.
+ * @details Lines (fiducials, point notes) are bucketed by x pixel with the
+ * selection tolerance folded into the bucket assignment, so a probe inspects
+ * exactly one bucket. Region notes and overlays go into a flat rect list.
+ */
+void ECGViewer::rebuildHoverIndex()
+{
+    const QRect axisRect = plot_->axisRect()->rect();
+    hoverIndex_.builtRect = axisRect;
+    hoverIndex_.builtRange = plot_->xAxis->range();
+    hoverIndex_.dirty = false;
+
+    const int nBuckets =
+        std::max(1, axisRect.width() / HoverIndex::kBucketPx + 2);
+    hoverIndex_.buckets.assign(static_cast<std::size_t>(nBuckets), {});
+    hoverIndex_.rects.clear();
+
+    const double tol = plot_->selectionTolerance();
+    const double left = axisRect.left();
+
+    auto bucketOf = [&](double xPx) {
+        const int b = static_cast<int>((xPx - left) / HoverIndex::kBucketPx);
+        return std::min(std::max(b, 0), nBuckets - 1);
+    };
+
+    auto addLine = [&](bool isNote, int index, double xPx) {
+        const int b1 = bucketOf(xPx + tol);
+        for (int b = bucketOf(xPx - tol); b <= b1; ++b)
+            hoverIndex_.buckets[static_cast<std::size_t>(b)].push_back(
+                {isNote, index, xPx});
+    };
+
+    const int lo = fiducials_.lowerBound(currentX0);
+    const int hi = fiducials_.upperBound(currentX1);
+    for (int i = lo; i < hi && i < fiducials_.size(); ++i)
+        addLine(false, i, plot_->xAxis->coordToPixel(fiducials_.timeAt(i)));
+
+    const double yTop = axisRect.top();
+    const double yBottom = axisRect.bottom();
+
+    for (int i = 0; i < notesCurrent_.size(); ++i) {
+        const NoteVisual& nv = notesCurrent_[i];
+        if (nv.noteIndex < 0 || nv.noteIndex >= notes_.size())
+            continue;
+        const Note& n = notes_[nv.noteIndex];
+        if (n.duration > 0.0) {
+            const double xl = plot_->xAxis->coordToPixel(n.time);
+            const double xr = plot_->xAxis->coordToPixel(n.time + n.duration);
+            hoverIndex_.rects.push_back(
+                {true, i, QRectF(QPointF(xl, yTop), QPointF(xr, yBottom))});
+        } else {
+            addLine(true, i, plot_->xAxis->coordToPixel(n.time));
+        }
+    }
+
+    for (int i = 0; i < overlays_.size(); ++i) {
+        const OverlayVisual& ov = overlays_[i];
+        if (!ov.visible || !overlaysVisible_)
+            continue;
+        const double xl = plot_->xAxis->coordToPixel(ov.x0 + ov.dx);
+        const double xr = plot_->xAxis->coordToPixel(ov.x1 + ov.dx);
+        const double yt = plot_->yAxis->coordToPixel(ov.y1 + ov.dy);
+        const double yb = plot_->yAxis->coordToPixel(ov.y0 + ov.dy);
+        hoverIndex_.rects.push_back(
+            {false, i, QRectF(QPointF(xl, yt), QPointF(xr, yb)).normalized()});
+    }
+}
+
+/**
+ * @brief Resolve what sits under @p pos using the hover index.
+ * @details Rebuilds first when the index is dirty or was built against a
+ * different x-range/axis rect (zoom, resize). Priority matches the old
+ * per-item walk: notes, then overlays, then fiducials; for line entries the
+ * nearest one within the selection tolerance wins.
+ */
+ECGViewer::HoverHit ECGViewer::probeHover(const QPointF& pos)
+{
+    if (hoverIndex_.dirty ||
+        hoverIndex_.builtRect != plot_->axisRect()->rect() ||
+        !(hoverIndex_.builtRange == plot_->xAxis->range()))
+        rebuildHoverIndex();
+
+    HoverHit hit;
+
+    const QRect& axisRect = hoverIndex_.builtRect;
+    if (!axisRect.contains(pos.toPoint()))
+        return hit;
+
+    const double tol = plot_->selectionTolerance();
+
+    int b = static_cast<int>((pos.x() - axisRect.left()) / HoverIndex::kBucketPx);
+    b = std::min(std::max(b, 0),
+                 static_cast<int>(hoverIndex_.buckets.size()) - 1);
+
+    double bestNote = tol + 1.0;
+    double bestFid = tol + 1.0;
+    for (const auto& e : hoverIndex_.buckets[static_cast<std::size_t>(b)]) {
+        const double d = std::abs(e.xPx - pos.x());
+        if (d > tol)
+            continue;
+        if (e.isNote) {
+            if (d < bestNote) { bestNote = d; hit.note = e.index; }
+        } else {
+            if (d < bestFid) { bestFid = d; hit.fiducial = e.index; }
+        }
+    }
+
+    for (const auto& r : hoverIndex_.rects) {
+        if (!r.rectPx.contains(pos))
+            continue;
+        if (r.isNote) {
+            if (hit.note < 0) hit.note = r.index;
+        } else {
+            if (hit.overlay < 0) hit.overlay = r.index;
+        }
+    }
+
+    if (hit.note >= 0) {
+        hit.overlay = -1;
+        hit.fiducial = -1;
+    } else if (hit.overlay >= 0) {
+        hit.fiducial = -1;
+    }
+
+    return hit;
+}
+
 /**
  * @brief Mouse move updates active drags or provides hover feedback.
  * @details Updates plot items in-place during drags for responsiveness, then queues replot.
@@ -239,7 +359,7 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
         const double x = mouseTimeClamped(event);
 
         updateOverlayRubberBand(overlayAnchorX_, x);
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         return;
     }
     if (overlayDragMode_ == OverlayDragMode::Moving &&
@@ -254,7 +374,7 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
         applyOverlayTransform(ov);
 
         setCursor(Qt::SizeHorCursor);
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         return;
     }
 
@@ -299,7 +419,7 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
             }
         }
 
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         return;
     }
 
@@ -376,37 +496,27 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
         }
 
         setCursor(Qt::SizeHorCursor);
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         return;
     }
 
     if (draggingFiducial_ && activeFiducialIndex_ >= 0)
     {
-        if (activeFiducialIndex_ >= fiducialsCurrent_.size())
+        if (activeFiducialIndex_ >= fiducials_.size())
             return;
 
-        auto& f = fiducialsCurrent_[activeFiducialIndex_];
-
         double mouseX = plot_->xAxis->pixelToCoord(event->pos().x());
         double newTime = clampTime(mouseX + dragOffsetSeconds_);
 
-        double yLow  = plot_->yAxis->range().lower;
-        double yHigh = plot_->yAxis->range().upper;
-
-        f.line->start->setCoords(newTime, yLow);
-        f.line->end->setCoords(newTime, yHigh);
-        f.text->position->setCoords(newTime, yHigh);
-
-        auto r = fiducialRefsFor(f.type);
-        f.text->setText(QString("%1 @ %2s").arg(r.label).arg(newTime, 0, 'f', 5));
-
         setCursor(Qt::ClosedHandCursor);
 
-        updatePoint(f, newTime);
+        // The store stays sorted, so the move may shift the entry's index;
+        // the layer redraws the marker at its new time on the next replot.
+        activeFiducialIndex_ = updatePoint(activeFiducialIndex_, newTime);
 
-        refreshFiducialGraph(f.type);
+        updateFiducialLines(currentX0, currentX1);
 
-        plot_->replot(QCustomPlot::rpQueuedReplot);
+        replotAnnotationLayer();
         return;
     }
 
@@ -417,42 +527,13 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
         return;
     }
 
-    QCPAbstractItem* item = plot_->itemAt(event->pos(), true);
-
-    int foundNoteIndex = -1;
-    int foundFidIndex  = -1;
-    int foundOverlayIndex = -1;
-
-    if (item) {
-        // Notes first
-        for (int i = 0; i < notesCurrent_.size(); ++i) {
-            const auto& nv = notesCurrent_[i];
-            if (nv.line == item || nv.text == item || nv.rect == item) {
-                foundNoteIndex = i;
-                break;
-            }
-        }
-
-        // Then fiducials
-        if (foundNoteIndex < 0) {
-            for (int i = 0; i < fiducialsCurrent_.size(); ++i) {
-                const auto& f = fiducialsCurrent_[i];
-                if (f.line == item || f.text == item) {
-                    foundFidIndex = i;
-                    break;
-                }
-            }
-        }
-
-        // Then overlays (rects)
-        if (foundNoteIndex < 0 && foundFidIndex < 0) {
-            overlayIndexFromItem(item, foundOverlayIndex);
-        }
-    }
+    // One O(1) probe of the pixel-space index instead of itemAt()'s walk over
+    // every plot item — this path runs for every motion event.
+    const HoverHit hit = probeHover(event->pos());
 
-    hoverNoteIndex_ = foundNoteIndex;
-    hoverFiducialIndex_ = foundFidIndex;
-    hoverOverlayIndex_ = foundOverlayIndex;
+    hoverNoteIndex_ = hit.note;
+    hoverFiducialIndex_ = hit.fiducial;
+    hoverOverlayIndex_ = hit.overlay;
 
     if ((hoverNoteIndex_ >= 0 && areNotesMoveable_) || 
         hoverFiducialIndex_ >= 0 || 
@@ -466,18 +547,23 @@ void ECGViewer::onPlotMouseMove(QMouseEvent* event)
 }
 
 /**
- * @brief Update backing fiducial vectors for a moved fiducial and resample Y.
+ * @brief Update the fiducial store for a moved fiducial and resample Y.
+ * @details The store stays time-sorted, so moving an entry can change its
+ * index; the entry's new store index is returned. The matching scatter point
+ * is moved in place rather than rebuilding the whole series.
  */
-void ECGViewer::updatePoint(FiducialVisual& f, double newTime)
+int ECGViewer::updatePoint(int storeIndex, double newTime)
 {
-    auto r = fiducialRefsFor(f.type);
-    QVector<double>& times = *r.times;
-    QVector<double>& vals = *r.vals;
+    if (storeIndex < 0 || storeIndex >= fiducials_.size())
+        return storeIndex;
 
-    if (f.index >= 0 && f.index < times.size()) {
-        times[f.index] = newTime;
-        vals[f.index] = cleanValueAtTime(newTime);
-    }
+    const FiducialType type = fiducials_.typeAt(storeIndex);
+    const double oldTime = fiducials_.timeAt(storeIndex);
+    const double newVal = cleanValueAtTime(newTime);
+
+    moveFiducialPoint(type, oldTime, newTime, newVal);
+
+    return fiducials_.setTime(storeIndex, newTime, newVal);
 }
 
 /**
@@ -528,6 +614,7 @@ void ECGViewer::onPlotMouseRelease(QMouseEvent* event)
             }
 
             clampNoteToBounds(n);
+            markNotesIndexDirty();
 
             updateNoteItems(currentX0, currentX1);
             refreshNotesList();
@@ -549,6 +636,7 @@ void ECGViewer::onPlotMouseRelease(QMouseEvent* event)
         draggingNote_ = false;
         activeNoteVisualIndex_ = -1;
         noteDragOffsetSeconds_ = 0.0;
+        markNotesIndexDirty();
 
         endItemDrag();
         plot_->replot();
@@ -564,16 +652,15 @@ void ECGViewer::onPlotMouseRelease(QMouseEvent* event)
     if (!draggingFiducial_ || activeFiducialIndex_ < 0)
         return;
 
-    auto& f = fiducialsCurrent_[activeFiducialIndex_];
-
-    updatePoint(f, f.line->start->coords().x());
-    refreshFiducialGraph(f.type);
-
+    // Every move already committed its time to the store; just clear state.
     draggingFiducial_ = false;
     activeFiducialIndex_ = -1;
     dragOffsetSeconds_ = 0.0;
 
     endItemDrag();
+
+    updateFiducialLines(currentX0, currentX1);
+
     plot_->replot();
 }
 
@@ -613,6 +700,8 @@ void ECGViewer::setOverlayMode(bool enabled)
 
 void ECGViewer::clearOverlays()
 {
+    markHoverIndexDirty();
+
     for (auto& ov : overlays_) {
         if (ov.rect) plot_->removeItem(ov.rect);
         ov.rect = nullptr;
@@ -637,6 +726,7 @@ void ECGViewer::clearOverlays()
 void ECGViewer::setOverlaysVisible(bool visible)
 {
     overlaysVisible_ = visible;
+    markHoverIndexDirty();
 
     for (auto& ov : overlays_) {
         ov.visible = visible;
@@ -703,6 +793,8 @@ void ECGViewer::applyOverlayTransform(OverlayVisual& ov)
 {
     if (!ov.graph) return;
 
+    markHoverIndexDirty();
+
     QVector<double> x;
     x.resize(ov.baseX.size());
 
@@ -740,6 +832,8 @@ void ECGViewer::applyOverlayTransform(OverlayVisual& ov)
  */
 void ECGViewer::finalizeOverlayFromSelection(double x0, double x1)
 {
+    markHoverIndexDirty();
+
     const double left = std::min(x0, x1);
     const double right = std::max(x0, x1);
 
@@ -822,6 +916,8 @@ void ECGViewer::deleteHoveredOverlay()
     if (hoverOverlayIndex_ < 0 || hoverOverlayIndex_ >= overlays_.size())
         return;
 
+    markHoverIndexDirty();
+
     OverlayVisual& ov = overlays_[hoverOverlayIndex_];
 
     if (ov.rect) {
@@ -5,7 +5,7 @@
  * This translation unit is responsible for drawing and refreshing the visible view:
  * - Updating the displayed ECG window (including downsampling for responsiveness)
  * - Toggling original vs cleaned traces depending on hide_artifacts_
- * - Rebuilding fiducial line/text items for the current x-range
+ * - Painting fiducial markers via the single FiducialLayerPlottable
  * - Rebuilding note visuals (point notes vs region rectangles)
  * - Managing window length changes and slider-driven navigation helpers
  *
@@ -19,64 +19,338 @@
 namespace ECGViewer {
 
 /**
- * @brief Update the plot to show the window starting at startSample.
- * @details Downsamples to a max point count for responsiveness; draws cleaned signal always,
- * and optionally the original signal when artifacts are not hidden.
+ * @brief Build all pyramid levels from the raw signal and artifact mask.
+ * @details Level 0 scans the raw samples sequentially; each higher level is a
+ * pairwise merge of the one below. Runs on a background thread; readers must
+ * check ready() before touching the tiles.
  */
-void ECGViewer::updateWindow(int startSample)
+void MinMaxPyramid::build(const SignalStore& v, const ArtifactRuns* runs)
 {
-    if (startSample < 0) startSample = 0;
-    if (startSample > max_start_sample_) startSample = max_start_sample_;
+    const int n = v.size();
+    if (n <= 0)
+        return;
+
+    levels_.clear();
+
+    const int nTiles = (n + kBaseTileSamples - 1) / kBaseTileSamples;
+    std::vector<Tile> base(nTiles);
+
+    // Tiles are visited in order, so a single run cursor marks each tile that
+    // overlaps an artifact run without touching per-sample mask bytes.
+    int ri = 0;
+    const int nRuns = runs ? runs->count() : 0;
+
+    for (int ti = 0; ti < nTiles; ++ti) {
+        const int s0 = ti * kBaseTileSamples;
+        const int s1 = std::min(s0 + kBaseTileSamples, n);
 
-    const int endSample = std::min(startSample + window_samples_, t_.size());
+        Tile tile;
+        tile.minV = v[s0];
+        tile.maxV = v[s0];
+
+        while (ri < nRuns && (*runs)[ri].end <= s0)
+            ++ri;
+        tile.artifact = (ri < nRuns && (*runs)[ri].start < s1) ? 1 : 0;
+
+        for (int i = s0 + 1; i < s1; ++i) {
+            const double x = v[i];
+            if (x < tile.minV) tile.minV = x;
+            if (x > tile.maxV) tile.maxV = x;
+        }
+        base[ti] = tile;
+    }
+
+    levels_.push_back(std::move(base));
+
+    while (levels_.back().size() > 1) {
+        const std::vector<Tile>& prev = levels_.back();
+        std::vector<Tile> next((prev.size() + 1) / 2);
+
+        for (std::size_t ti = 0; ti < next.size(); ++ti) {
+            const Tile& a = prev[2 * ti];
+            Tile merged = a;
+            if (2 * ti + 1 < prev.size()) {
+                const Tile& b = prev[2 * ti + 1];
+                merged.minV = std::min(a.minV, b.minV);
+                merged.maxV = std::max(a.maxV, b.maxV);
+                merged.artifact = a.artifact | b.artifact;
+            }
+            next[ti] = merged;
+        }
+        levels_.push_back(std::move(next));
+    }
+
+    ready_.store(true, std::memory_order_release);
+}
+
+int MinMaxPyramid::levelForStep(int step) const
+{
+    int level = 0;
+    while (level + 1 < static_cast<int>(levels_.size()) && tileSamples(level) < step)
+        ++level;
+    return level;
+}
+
+/**
+ * @brief Decimate one window of signal data into ready-to-plot buffers.
+ * @details Uses a peak-preserving min/max envelope (pyramid tiles when
+ * available, a bucketed scan otherwise). Reads only the immutable signal
+ * views and pyramids plus the key fields of @p buf, so it is safe to call
+ * from the prefetch thread concurrently with GUI work.
+ */
+void ECGViewer::computeWindowBuffers(WindowBuffers& buf) const
+{
+    const int startSample = buf.startSample;
+    const int endSample = std::min(startSample + buf.windowSamples, t_.size());
 
     const int rawCount = endSample - startSample;
     const int maxPoints = 5000;
     int step = rawCount > maxPoints ? (rawCount / maxPoints) : 1;
     if (step < 1) step = 1;
 
-    QVector<double> txBase, vyBase;
-    QVector<double> txNoise, vyNoise;
-    QVector<double> txOrigFull, vyOrigFull;
-
-    txBase.reserve(rawCount / step + 1);
-    vyBase.reserve(rawCount / step + 1);
-    txNoise.reserve(rawCount / step + 1);
-    vyNoise.reserve(rawCount / step + 1);
-    txOrigFull.reserve(rawCount / step + 1);
-    vyOrigFull.reserve(rawCount / step + 1);
+    QVector<double>& txBase = buf.txBase;
+    QVector<double>& vyBase = buf.vyBase;
+    QVector<double>& txNoise = buf.txNoise;
+    QVector<double>& vyNoise = buf.vyNoise;
+    QVector<double>& txOrigFull = buf.txOrigFull;
+    QVector<double>& vyOrigFull = buf.vyOrigFull;
 
+    const bool hideArtifacts = buf.hideArtifacts;
     const double t0 = t_.first();
 
-    for (int i = startSample; i < endSample; i += step) {
-        const double tRel = t_[i] - t0;
-        const double vO   = vOrig_[i];
-        const double vC   = vClean_[i];
-        const bool isArt  = (artMask_[i] != 0);
+    if (step >= MinMaxPyramid::kBaseTileSamples &&
+        pyramidClean_.ready() && pyramidOrig_.ready()) {
+        // Pyramid path: serve the window from precomputed min/max tiles at the
+        // level matching the decimation step -- O(pixels) tile reads instead of
+        // an O(window) raw-sample scan.
+        const int level = pyramidClean_.levelForStep(step);
+        const int w = pyramidClean_.tileSamples(level);
+        const auto& clean = pyramidClean_.tiles(level);
+        const auto& orig = pyramidOrig_.tiles(level);
+
+        const int tiFirst = startSample / w;
+        const int tiLast = std::min((endSample - 1) / w,
+                                    static_cast<int>(clean.size()) - 1);
+        const int nTiles = tiLast - tiFirst + 1;
+
+        txBase.reserve(2 * nTiles);
+        vyBase.reserve(2 * nTiles);
+        txOrigFull.reserve(2 * nTiles);
+        vyOrigFull.reserve(2 * nTiles);
+
+        const int lastSample = t_.size() - 1;
+
+        for (int ti = tiFirst; ti <= tiLast; ++ti) {
+            const int s0 = std::min(ti * w, lastSample);
+            const int sMid = std::min(s0 + w / 2, lastSample);
+            const double x0r = t_[s0] - t0;
+            const double x1r = t_[sMid] - t0;
+
+            // Artifact tiles are omitted from the clean base trace, matching
+            // the per-sample mask split of the direct path.
+            const MinMaxPyramid::Tile& ct = clean[ti];
+            if (!ct.artifact) {
+                txBase.push_back(x0r);
+                vyBase.push_back(ct.minV);
+                txBase.push_back(x1r);
+                vyBase.push_back(ct.maxV);
+            }
+
+            if (!hideArtifacts) {
+                const MinMaxPyramid::Tile& ot = orig[ti];
+                txOrigFull.push_back(x0r);
+                vyOrigFull.push_back(ot.minV);
+                txOrigFull.push_back(x1r);
+                vyOrigFull.push_back(ot.maxV);
+            }
+        }
+    } else if (step > 1) {
+        // Bucketed min/max envelope: one sequential pass, two points per
+        // bucket. Unlike stride sampling this never drops an R-wave peak,
+        // and the contiguous access pattern is cache-friendly.
+        const int nBuckets = (rawCount + step - 1) / step;
+
+        txBase.reserve(2 * nBuckets);
+        vyBase.reserve(2 * nBuckets);
+        txNoise.reserve(2 * nBuckets);
+        vyNoise.reserve(2 * nBuckets);
+        txOrigFull.reserve(2 * nBuckets);
+        vyOrigFull.reserve(2 * nBuckets);
+
+        // One artifact-run cursor for the whole window: buckets and spans are
+        // visited in ascending sample order, so the cursor only moves forward.
+        int ri = artRuns_.firstRunAfter(startSample);
+
+        for (int b0 = startSample; b0 < endSample; b0 += step) {
+            const int b1 = std::min(b0 + step, endSample);
+            const int bMid = std::min(b0 + step / 2, endSample - 1);
+            const double x0r = t_[b0] - t0;
+            const double x1r = t_[bMid] - t0;
+
+            double cleanMin = 0.0, cleanMax = 0.0;
+            double noiseMin = 0.0, noiseMax = 0.0;
+            double origMin = vOrig_[b0], origMax = vOrig_[b0];
+            bool haveClean = false, haveNoise = false;
+
+            for (int i = b0; i < b1; ++i) {
+                const double vO = vOrig_[i];
+                if (vO < origMin) origMin = vO;
+                if (vO > origMax) origMax = vO;
+            }
+
+            // Split the bucket into alternating clean/artifact spans; each
+            // span's min/max loop is branch-free over the cleaned samples.
+            int pos = b0;
+            while (pos < b1) {
+                while (ri < artRuns_.count() && artRuns_[ri].end <= pos)
+                    ++ri;
+                const bool inArt =
+                    ri < artRuns_.count() && artRuns_[ri].start <= pos;
+                const int spanEnd =
+                    inArt ? std::min(b1, artRuns_[ri].end)
+                          : (ri < artRuns_.count()
+                                 ? std::min(b1, artRuns_[ri].start)
+                                 : b1);
+
+                double lo = vClean_[pos], hi = lo;
+                for (int i = pos + 1; i < spanEnd; ++i) {
+                    const double vC = vClean_[i];
+                    if (vC < lo) lo = vC;
+                    if (vC > hi) hi = vC;
+                }
+
+                if (inArt) {
+                    noiseMin = haveNoise ? std::min(noiseMin, lo) : lo;
+                    noiseMax = haveNoise ? std::max(noiseMax, hi) : hi;
+                    haveNoise = true;
+                } else {
+                    cleanMin = haveClean ? std::min(cleanMin, lo) : lo;
+                    cleanMax = haveClean ? std::max(cleanMax, hi) : hi;
+                    haveClean = true;
+                }
+                pos = spanEnd;
+            }
+
+            if (!hideArtifacts) {
+                txOrigFull.push_back(x0r);
+                vyOrigFull.push_back(origMin);
+                txOrigFull.push_back(x1r);
+                vyOrigFull.push_back(origMax);
+            }
+
+            if (haveClean) {
+                txBase.push_back(x0r);
+                vyBase.push_back(cleanMin);
+                txBase.push_back(x1r);
+                vyBase.push_back(cleanMax);
+            }
+            if (haveNoise) {
+                txNoise.push_back(x0r);
+                vyNoise.push_back(noiseMin);
+                txNoise.push_back(x1r);
+                vyNoise.push_back(noiseMax);
+            }
+        }
+    } else {
+        txBase.reserve(rawCount + 1);
+        vyBase.reserve(rawCount + 1);
+        txNoise.reserve(rawCount + 1);
+        vyNoise.reserve(rawCount + 1);
+        txOrigFull.reserve(rawCount + 1);
+        vyOrigFull.reserve(rawCount + 1);
+
+        if (!hideArtifacts) {
+            for (int i = startSample; i < endSample; ++i) {
+                txOrigFull.push_back(t_[i] - t0);
+                vyOrigFull.push_back(vOrig_[i]);
+            }
+        }
 
-        if (!hide_artifacts_) {
-            txOrigFull.push_back(tRel);
-            vyOrigFull.push_back(vO);
+        // Emit the cleaned trace per artifact segment: each contiguous span
+        // goes to either the base or the noise buffers with no per-sample test.
+        int pos = startSample;
+        int ri = artRuns_.firstRunAfter(startSample);
+        while (pos < endSample) {
+            while (ri < artRuns_.count() && artRuns_[ri].end <= pos)
+                ++ri;
+            const bool inArt =
+                ri < artRuns_.count() && artRuns_[ri].start <= pos;
+            const int spanEnd =
+                inArt ? std::min(endSample, artRuns_[ri].end)
+                      : (ri < artRuns_.count()
+                             ? std::min(endSample, artRuns_[ri].start)
+                             : endSample);
+
+            QVector<double>& tx = inArt ? txNoise : txBase;
+            QVector<double>& vy = inArt ? vyNoise : vyBase;
+            for (int i = pos; i < spanEnd; ++i) {
+                tx.push_back(t_[i] - t0);
+                vy.push_back(vClean_[i]);
+            }
+            pos = spanEnd;
         }
+    }
 
-        if (isArt) {
-            txNoise.push_back(tRel);
-            vyNoise.push_back(vC);
-        } else {
-            txBase.push_back(tRel);
-            vyBase.push_back(vC);
+}
+
+/**
+ * @brief Update the plot to show the window starting at startSample.
+ * @details Serves the window from the prefetch cache when the worker has
+ * already decimated it (a buffer swap), otherwise decimates synchronously.
+ * Draws cleaned signal always, and optionally the original signal when
+ * artifacts are not hidden; finishes by queueing prefetches for the
+ * neighbouring windows.
+ */
+void ECGViewer::updateWindow(int startSample)
+{
+    PerfTimer frameTimer("viewer.frame_ms");
+
+    if (startSample < 0) startSample = 0;
+    if (startSample > max_start_sample_) startSample = max_start_sample_;
+
+    WindowBuffers buf;
+    buf.startSample = startSample;
+    buf.windowSamples = window_samples_;
+    buf.hideArtifacts = hide_artifacts_;
+
+    bool fromCache = false;
+    {
+        PerfTimer timer("viewer.decimate_ms");
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex_);
+            for (auto it = prefetchReady_.begin(); it != prefetchReady_.end(); ++it) {
+                if (it->startSample == buf.startSample &&
+                    it->windowSamples == buf.windowSamples &&
+                    it->hideArtifacts == buf.hideArtifacts) {
+                    buf = std::move(*it);
+                    prefetchReady_.erase(it);
+                    fromCache = true;
+                    break;
+                }
+            }
         }
+
+        if (!fromCache)
+            computeWindowBuffers(buf);
     }
 
-    graphCleanBase_->setData(txBase, vyBase);
+    PerfStats::instance().record("viewer.prefetch_hit", fromCache ? 1.0 : 0.0);
+    PerfStats::instance().record(
+        "viewer.points_per_frame",
+        static_cast<double>(buf.txBase.size() + buf.txNoise.size() +
+                            buf.txOrigFull.size()));
+
+    graphCleanBase_->setData(buf.txBase, buf.vyBase);
 
     if (!hide_artifacts_) {
-        graphOrigFull_->setData(txOrigFull, vyOrigFull);
+        graphOrigFull_->setData(buf.txOrigFull, buf.vyOrigFull);
         graphOrigFull_->setVisible(true);
     } else {
         graphOrigFull_->setVisible(false);
     }
 
+    const double t0 = t_.first();
     const double x0 = t_[startSample] - t0;
     const double x1 = x0 + window_s_;
     currentX0 = x0;
@@ -86,7 +360,131 @@ void ECGViewer::updateWindow(int startSample)
     updateFiducialLines(x0, x1);
     updateNoteItems(x0, x1);
 
-    plot_->replot();
+    {
+        PerfTimer timer("viewer.replot_ms");
+        // Queued: merges with any replot the drag handlers queued in the same
+        // event-loop pass, so a frame is painted at most once.
+        plot_->replot(QCustomPlot::rpQueuedReplot);
+    }
+
+    schedulePrefetch(startSample);
+}
+
+/**
+ * @brief Ask for a window without rendering it synchronously.
+ * @details Stale pending requests are overwritten (latest value wins) and the
+ * frame-paced timer applies the survivor, so scrubbing an 8-hour record
+ * tracks the slider thumb at the timer rate regardless of event rate.
+ */
+void ECGViewer::requestWindow(int startSample)
+{
+    if (!windowUpdateTimer_) {
+        updateWindow(startSample);
+        return;
+    }
+
+    pendingStartSample_ = startSample;
+    if (!windowUpdateTimer_->isActive())
+        windowUpdateTimer_->start();
+}
+
+/**
+ * @brief Queue speculative decimation of the windows a navigation step away.
+ * @details Candidates are one window left/right at the current zoom plus the
+ * current window at the next zoom levels (the 1.5x steps the zoom buttons
+ * use). The pending task list is replaced wholesale so the worker always
+ * serves the latest view.
+ */
+void ECGViewer::schedulePrefetch(int startSample)
+{
+    std::vector<WindowBuffers> tasks;
+
+    auto addTask = [&](int start, int windowSamples) {
+        if (windowSamples < 1)
+            return;
+        const int maxStart = std::max(0, t_.size() - windowSamples - 1);
+        if (start < 0) start = 0;
+        if (start > maxStart) start = maxStart;
+        if (start == startSample && windowSamples == window_samples_)
+            return;
+
+        WindowBuffers task;
+        task.startSample = start;
+        task.windowSamples = windowSamples;
+        task.hideArtifacts = hide_artifacts_;
+
+        for (const auto& queued : tasks) {
+            if (queued.startSample == task.startSample &&
+                queued.windowSamples == task.windowSamples)
+                return;
+        }
+        tasks.push_back(task);
+    };
+
+    // Mirror updateWindowLength()'s clamping so the keys match what a zoom
+    // would actually request.
+    auto zoomSamples = [&](double seconds) {
+        if (seconds < min_window_s_) seconds = min_window_s_;
+        if (seconds > total_time_) seconds = total_time_;
+        return std::max(1, static_cast<int>(seconds * fs_));
+    };
+
+    addTask(startSample - window_samples_, window_samples_);
+    addTask(startSample + window_samples_, window_samples_);
+    addTask(startSample, zoomSamples(window_s_ / 1.5));
+    addTask(startSample, zoomSamples(window_s_ * 1.5));
+
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+
+        // Drop candidates already decimated under the same key.
+        auto alreadyReady = [this](const WindowBuffers& task) {
+            for (const auto& ready : prefetchReady_) {
+                if (ready.startSample == task.startSample &&
+                    ready.windowSamples == task.windowSamples &&
+                    ready.hideArtifacts == task.hideArtifacts)
+                    return true;
+            }
+            return false;
+        };
+        tasks.erase(std::remove_if(tasks.begin(), tasks.end(), alreadyReady),
+                    tasks.end());
+
+        prefetchTasks_ = std::move(tasks);
+    }
+    prefetchCv_.notify_one();
+}
+
+/**
+ * @brief Prefetch worker body: decimate queued windows until shutdown.
+ * @details Pops one task at a time so a newly scheduled batch replaces stale
+ * work between computations; finished buffers land in a small LRU-style
+ * cache that updateWindow() consumes.
+ */
+void ECGViewer::prefetchLoop()
+{
+    for (;;) {
+        WindowBuffers task;
+        {
+            std::unique_lock<std::mutex> lock(prefetchMutex_);
+            prefetchCv_.wait(lock, [this]() {
+                return prefetchStop_ || !prefetchTasks_.empty();
+            });
+            if (prefetchStop_)
+                return;
+            task = std::move(prefetchTasks_.front());
+            prefetchTasks_.erase(prefetchTasks_.begin());
+        }
+
+        computeWindowBuffers(task);
+
+        {
+            std::lock_guard<std::mutex> lock(prefetchMutex_);
+            prefetchReady_.push_back(std::move(task));
+            while (static_cast<int>(prefetchReady_.size()) > kPrefetchCacheSize)
+                prefetchReady_.erase(prefetchReady_.begin());
+        }
+    }
 }
 
 /**
@@ -116,106 +514,184 @@ void ECGViewer::updateWindowLength(double newWindowSeconds)
 }
 
 /**
- * @brief Rebuild fiducial vertical line/text items for the visible x-range.
- * @details Each type contributes zero or more markers. Items are fully recreated each call.
+ * @brief Point the fiducial layer at the store slice covering [x0, x1].
+ * @details Binary-searches the sorted fiducial store, so the cost per window
+ * change is O(log n) regardless of total marker count; the actual drawing
+ * happens inside FiducialLayerPlottable::draw() on the next replot.
  */
 void ECGViewer::updateFiducialLines(double x0, double x1)
 {
-    for (auto* item : fiducialItems_) {
-        plot_->removeItem(item);
-    }
-    fiducialItems_.clear();
-    fiducialsCurrent_.clear();
-
-    auto addLinesFor = [this, x0, x1](const QVector<double>& times,
-                                     const QVector<double>& /*vals*/,
-                                     FiducialType type,
-                                     const QString& label,
-                                     const QColor& color)
-    {
-        for (int i = 0; i < times.size(); ++i) {
-            double t = times[i];
-            if (t < x0 || t > x1)
-                continue;
-
-            auto* line = new QCPItemLine(plot_);
-            line->start->setCoords(t, plot_->yAxis->range().lower);
-            line->end->setCoords(t, plot_->yAxis->range().upper);
-            line->setPen(QPen(color, 0.8, Qt::DashLine));
-            line->setSelectable(true);
+    PerfTimer timer("viewer.fiducials_ms");
 
-            auto* txt = new QCPItemText(plot_);
-            txt->position->setCoords(t, plot_->yAxis->range().upper);
-            txt->setPositionAlignment(Qt::AlignRight | Qt::AlignTop);
-            txt->setText(QString("%1 @ %2s").arg(label).arg(t, 0, 'f', 5));
-            txt->setColor(color);
-            txt->setClipToAxisRect(true);
-            txt->setRotation(-90);
-            txt->setSelectable(true);
+    markHoverIndexDirty();
+
+    if (!fidLayer_)
+        return;
+
+    fidLayer_->setVisibleRange(fiducials_.lowerBound(x0),
+                               fiducials_.upperBound(x1));
+}
+
+FiducialLayerPlottable::FiducialLayerPlottable(QCPAxis* keyAxis,
+                                               QCPAxis* valueAxis,
+                                               ECGViewer* viewer)
+    : QCPAbstractPlottable(keyAxis, valueAxis), viewer_(viewer)
+{
+    setName(QStringLiteral("fiducials"));
+    // Selection is handled by the viewer's own hover/drag logic via hitTest().
+    setSelectable(QCP::stNone);
+}
 
-            fiducialItems_.push_back(line);
-            fiducialItems_.push_back(txt);
+/**
+ * @brief Paint every fiducial in [lo_, hi_) in one pass.
+ * @details Mirrors the look of the old per-marker items: a dashed coloured
+ * vertical line spanning the axis rect plus a rotated "<label> @ <t>s" text
+ * along its top. One pen change per marker, no per-marker heap objects.
+ */
+void FiducialLayerPlottable::draw(QCPPainter* painter)
+{
+    const ECGViewer::FiducialStore& store = viewer_->fiducials_;
+    const QRectF clip = clipRect();
+
+    for (int i = lo_; i < hi_ && i < store.size(); ++i) {
+        const double t = store.timeAt(i);
+        const double x = keyAxis()->coordToPixel(t);
+        if (x < clip.left() - 1.0 || x > clip.right() + 1.0)
+            continue;
+
+        const ECGViewer::FiducialType type = store.typeAt(i);
+        const QColor color = viewer_->fiducialColor(type);
+
+        painter->setPen(QPen(color, 0.8, Qt::DashLine));
+        painter->drawLine(QPointF(x, clip.top()), QPointF(x, clip.bottom()));
+
+        painter->setPen(QPen(color));
+        painter->save();
+        painter->translate(x, clip.top());
+        painter->rotate(90);
+        painter->drawText(QPointF(2.0, -3.0),
+                          QString("%1 @ %2s")
+                              .arg(viewer_->fiducialLabel(type))
+                              .arg(t, 0, 'f', 5));
+        painter->restore();
+    }
+}
 
-            FiducialVisual fv;
-            fv.type = type;
-            fv.index = i;
-            fv.line = line;
-            fv.text = txt;
-            fiducialsCurrent_.push_back(fv);
+/**
+ * @brief Nearest visible marker line within the plot's selection tolerance.
+ * @return Store index, or -1 when nothing is close enough.
+ */
+int FiducialLayerPlottable::hitTest(const QPointF& pos) const
+{
+    if (!mParentPlot)
+        return -1;
+
+    const double tol = mParentPlot->selectionTolerance();
+    const QRectF clip = clipRect();
+    if (pos.y() < clip.top() || pos.y() > clip.bottom())
+        return -1;
+
+    const ECGViewer::FiducialStore& store = viewer_->fiducials_;
+    int best = -1;
+    double bestDist = tol + 1.0;
+    for (int i = lo_; i < hi_ && i < store.size(); ++i) {
+        const double d = qAbs(keyAxis()->coordToPixel(store.timeAt(i)) - pos.x());
+        if (d < bestDist) {
+            bestDist = d;
+            best = i;
         }
-    };
+    }
+    return (bestDist <= tol) ? best : -1;
+}
+
+double FiducialLayerPlottable::selectTest(const QPointF& pos, bool onlySelectable,
+                                          QVariant* details) const
+{
+    Q_UNUSED(details)
+    if (onlySelectable && selectable() == QCP::stNone)
+        return -1.0;
+
+    const int idx = hitTest(pos);
+    if (idx < 0)
+        return -1.0;
+    return qAbs(keyAxis()->coordToPixel(viewer_->fiducials_.timeAt(idx)) - pos.x());
+}
 
-    addLinesFor(pTimes_, pVals_, FiducialType::P, "P", useColourBlindPalette_ ? QColor("#56B4E9") : Qt::blue);
-    addLinesFor(psTimes_, psVals_, FiducialType::Ps, "Ps", useColourBlindPalette_ ? QColor("#56B4E9") : Qt::blue);
-    addLinesFor(peTimes_, peVals_, FiducialType::Pe, "Pe", useColourBlindPalette_ ? QColor("#56B4E9") : Qt::blue);
-    addLinesFor(qTimes_, qVals_, FiducialType::Q, "Q", useColourBlindPalette_ ? QColor("#0072B2") : Qt::green);
-    addLinesFor(rTimes_, rVals_, FiducialType::R, "R", useColourBlindPalette_ ? QColor("#E69F00") : Qt::red);
-    addLinesFor(sTimes_, sVals_, FiducialType::S, "S", useColourBlindPalette_ ? QColor("#CC79A7") : Qt::magenta);
-    addLinesFor(tTimes_, tVals_, FiducialType::T, "T", useColourBlindPalette_ ? QColor("#D55E00") : QColor(255, 140, 0));
-    addLinesFor(tsTimes_, tsVals_, FiducialType::Ts, "Ts", useColourBlindPalette_ ? QColor("#D55E00") : QColor(255, 140, 0));
-    addLinesFor(teTimes_, teVals_, FiducialType::Te, "Te", useColourBlindPalette_ ? QColor("#D55E00") : QColor(255, 140, 0));
+// Markers never drive axis rescaling; the signal graphs own the ranges.
+QCPRange FiducialLayerPlottable::getKeyRange(bool& foundRange,
+                                             QCP::SignDomain inSignDomain) const
+{
+    Q_UNUSED(inSignDomain)
+    foundRange = false;
+    return QCPRange();
+}
+
+QCPRange FiducialLayerPlottable::getValueRange(bool& foundRange,
+                                               QCP::SignDomain inSignDomain,
+                                               const QCPRange& inKeyRange) const
+{
+    Q_UNUSED(inSignDomain)
+    Q_UNUSED(inKeyRange)
+    foundRange = false;
+    return QCPRange();
+}
+
+void FiducialLayerPlottable::drawLegendIcon(QCPPainter* painter, const QRectF& rect) const
+{
+    painter->setPen(QPen(Qt::gray, 0.8, Qt::DashLine));
+    painter->drawLine(QPointF(rect.center().x(), rect.top()),
+                      QPointF(rect.center().x(), rect.bottom()));
 }
 
 /**
  * @brief Rebuild note items for the visible x-range.
- * @details Point notes are drawn as a vertical line + label, region notes as a rect + label.
+ * @details Visible notes come from the interval index (rebuilt lazily after
+ * note mutations), so per-frame work is proportional to what intersects the
+ * window. Point notes are drawn as a vertical line + label, region notes as
+ * a rect + label.
  */
 void ECGViewer::updateNoteItems(double x0, double x1)
 {
+    PerfTimer timer("viewer.notes_ms");
+
+    markHoverIndexDirty();
+
     for (auto& nv : notesCurrent_) {
-        if (nv.line) plot_->removeItem(nv.line);
-        if (nv.rect) plot_->removeItem(nv.rect);
-        if (nv.text) plot_->removeItem(nv.text);
+        releaseLineItem(nv.line);
+        releaseRectItem(nv.rect);
+        releaseTextItem(nv.text);
     }
     notesCurrent_.clear();
 
+    if (notesIndexDirty_) {
+        notesIndex_.rebuild(notes_);
+        notesIndexDirty_ = false;
+    }
+
     const double yLow  = plot_->yAxis->range().lower;
     const double yHigh = plot_->yAxis->range().upper;
 
-    for (int i = 0; i < notes_.size(); ++i) {
+    const QVector<int> visible = notesIndex_.query(notes_, x0, x1);
+
+    for (int i : visible) {
         const Note& n = notes_[i];
 
         const double t0 = n.time;
         const double t1 = n.time + std::max(0.0, n.duration);
 
         const bool isRegion = (n.duration > 0.0);
-        if (!isRegion) {
-            if (t0 < x0 || t0 > x1) continue;
-        } else {
-            if (t1 < x0 || t0 > x1) continue;
-        }
 
         NoteVisual nv;
         nv.noteIndex = i;
 
         if (!isRegion) {
-            auto* line = new QCPItemLine(plot_);
+            auto* line = acquireLineItem();
             line->start->setCoords(t0, yLow);
             line->end->setCoords(t0, yHigh);
             line->setPen(QPen(Qt::darkCyan, 1.0, Qt::DashLine));
             line->setSelectable(true);
 
-            auto* txt = new QCPItemText(plot_);
+            auto* txt = acquireTextItem();
             txt->position->setCoords(t0, yHigh);
             txt->setPositionAlignment(Qt::AlignRight | Qt::AlignTop);
             txt->setText(n.tag.isEmpty() ? QStringLiteral("Note") : n.tag);
@@ -228,7 +704,7 @@ void ECGViewer::updateNoteItems(double x0, double x1)
             nv.line = line;
             nv.text = txt;
         } else {
-            auto* rect = new QCPItemRect(plot_);
+            auto* rect = acquireRectItem();
             rect->topLeft->setCoords(t0, yHigh);
             rect->bottomRight->setCoords(t1, yLow);
 
@@ -239,7 +715,7 @@ void ECGViewer::updateNoteItems(double x0, double x1)
             rect->setSelectable(true);
             rect->setClipToAxisRect(true);
 
-            auto* txt = new QCPItemText(plot_);
+            auto* txt = acquireTextItem();
             txt->position->setCoords(t0, yHigh);
             txt->setPositionAlignment(Qt::AlignLeft | Qt::AlignTop);
             txt->setText(n.tag.isEmpty() ? QStringLiteral("Region") : n.tag);
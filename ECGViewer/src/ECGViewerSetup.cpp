@@ -194,10 +194,10 @@ void ECGViewer::setStyle() {
  * - Manual fiducial insertion tab
  * - Axis range clamp handler that maps x-range to slider position
  */
-ECGViewer::ECGViewer(const QVector<double>& t,
-                     const QVector<double>& vOrig,
-                     const QVector<double>& vClean,
-                     const QVector<unsigned char>& artMask,
+ECGViewer::ECGViewer(TimeAxis t,
+                     SignalView<double> vOrig,
+                     SignalView<double> vClean,
+                     SignalView<unsigned char> artMask,
                      double fs,
                      double window_s,
                      bool has_ylim,
@@ -205,6 +205,8 @@ ECGViewer::ECGViewer(const QVector<double>& t,
                      double ymax,
                      bool hide_artifacts,
                      bool colour_blind_mode,
+                     bool quantize,
+                     bool use_opengl,
                      const QVector<double>& pTimes,
                      const QVector<double>& pVals,
                      const QVector<double>& psTimes,
@@ -226,32 +228,48 @@ ECGViewer::ECGViewer(const QVector<double>& t,
                      const QString& filePrefix,
                      QWidget* parent)
     : QMainWindow(parent),
-      t_(t),
-      vOrig_(vOrig),
-      vClean_(vClean),
-      artMask_(artMask),
-      pTimes_(pTimes), pVals_(pVals),
-      psTimes_(psTimes), psVals_(psVals),
-      peTimes_(peTimes), peVals_(peVals),
-      qTimes_(qTimes), qVals_(qVals),
-      rTimes_(rTimes), rVals_(rVals),
-      sTimes_(sTimes), sVals_(sVals),
-      tTimes_(tTimes), tVals_(tVals),
-      tsTimes_(tsTimes), tsVals_(tsVals),
-      teTimes_(teTimes), teVals_(teVals),
+      t_(std::move(t)),
       fs_(fs),
       window_s_(window_s),
       hide_artifacts_(hide_artifacts),
       filePrefix_(filePrefix),
       useColourBlindPalette_(colour_blind_mode)
 {
+    // Voltage storage: zero-copy views by default, int16 + scale/offset when
+    // the caller opts into quantized mode (4x smaller working set).
+    if (quantize) {
+        vOrig_.quantizeFrom(vOrig);
+        vClean_.quantizeFrom(vClean);
+    } else {
+        vOrig_.adopt(std::move(vOrig));
+        vClean_.adopt(std::move(vClean));
+    }
+
     if (t_.size() != vOrig_.size() ||
         t_.size() != vClean_.size() ||
-        t_.size() != artMask_.size() ||
+        t_.size() != artMask.size() ||
         t_.isEmpty()) {
         throw std::runtime_error("All input vectors must be non-empty and of equal length");
     }
 
+    // Compact the byte mask into run-length segments and let the caller's
+    // mask buffer go; windowed plotting splits clean vs noise per run.
+    artRuns_.build(artMask);
+    artMask = SignalView<unsigned char>();
+
+    // All nine fiducial series go into one time-sorted store; the per-type
+    // scatter graphs are rebuilt from it below.
+    fiducials_.load(FiducialType::P, pTimes, pVals);
+    fiducials_.load(FiducialType::Ps, psTimes, psVals);
+    fiducials_.load(FiducialType::Pe, peTimes, peVals);
+    fiducials_.load(FiducialType::Q, qTimes, qVals);
+    fiducials_.load(FiducialType::R, rTimes, rVals);
+    fiducials_.load(FiducialType::S, sTimes, sVals);
+    fiducials_.load(FiducialType::T, tTimes, tVals);
+    fiducials_.load(FiducialType::Ts, tsTimes, tsVals);
+    fiducials_.load(FiducialType::Te, teTimes, teVals);
+    fiducials_.finalize();
+
     total_time_ = t_.last() - t_.first();
     if (total_time_ <= 0.0) {
         total_time_ = 1.0 / std::max(fs_, 1.0);
@@ -274,6 +292,24 @@ ECGViewer::ECGViewer(const QVector<double>& t,
     auto* vbox = new QVBoxLayout(central);
 
     plot_ = new QCustomPlot(central);
+
+    // Optional GPU rendering: only available when the module was built with
+    // -DECG_USE_OPENGL=ON (which defines QCUSTOMPLOT_USE_OPENGL for
+    // qcustomplot.cpp). setOpenGl() can fail at runtime if no GL context can
+    // be created (remote desktop, headless); in that case QCustomPlot falls
+    // back to the software rasterizer and openGl() stays false.
+    if (use_opengl) {
+#ifdef QCUSTOMPLOT_USE_OPENGL
+        plot_->setOpenGl(true);
+        if (!plot_->openGl())
+            qWarning("ECGViewer: OpenGL context creation failed, "
+                     "using software rendering");
+#else
+        qWarning("ECGViewer: use_opengl requested but module was built "
+                 "without ECG_USE_OPENGL; using software rendering");
+#endif
+    }
+
     plot_->setBackground(QBrush(QColor(255, 255, 255)));
     setStyle();
 
@@ -306,6 +342,20 @@ ECGViewer::ECGViewer(const QVector<double>& t,
     y_min_orig_ = plot_->yAxis->range().lower;
     y_max_orig_ = plot_->yAxis->range().upper;
 
+    // Layer stack: the decimated signal traces and the annotation visuals
+    // each get their own buffered backing store. Dragging a marker then
+    // repaints only the annotation buffer, while the (much heavier) signal
+    // traces composite from their cached pixmap.
+    plot_->addLayer(QStringLiteral("signals"),
+                    plot_->layer(QStringLiteral("main")), QCustomPlot::limAbove);
+    plot_->layer(QStringLiteral("signals"))->setMode(QCPLayer::lmBuffered);
+    plot_->addLayer(QStringLiteral("annotations"),
+                    plot_->layer(QStringLiteral("signals")), QCustomPlot::limAbove);
+    annotationLayer_ = plot_->layer(QStringLiteral("annotations"));
+    annotationLayer_->setMode(QCPLayer::lmBuffered);
+
+    plot_->setCurrentLayer(QStringLiteral("signals"));
+
     graphCleanBase_ = plot_->addGraph();
     graphCleanBase_->setPen(QPen(Qt::blue, 1.2));
 
@@ -317,6 +367,11 @@ ECGViewer::ECGViewer(const QVector<double>& t,
         graphOrigFull_->setPen(p);
     }
 
+    // Everything created from here on — the scatter graphs, the fiducial
+    // layer plottable and every note/overlay item (including the pooled
+    // items acquired later) — lands on the annotation buffer.
+    plot_->setCurrentLayer(QStringLiteral("annotations"));
+
     auto makeScatterGraph = [this](const QColor& color, QCPScatterStyle::ScatterShape shape,
                                    double size) -> QCPGraph* {
         QCPGraph* g = plot_->addGraph();
@@ -335,11 +390,16 @@ ECGViewer::ECGViewer(const QVector<double>& t,
 
 
 
-    graphP_->setData(pTimes_, pVals_);
-    graphQ_->setData(qTimes_, qVals_);
-    graphR_->setData(rTimes_, rVals_);
-    graphS_->setData(sTimes_, sVals_);
-    graphT_->setData(tTimes_, tVals_);
+    refreshFiducialGraph(FiducialType::P);
+    refreshFiducialGraph(FiducialType::Q);
+    refreshFiducialGraph(FiducialType::R);
+    refreshFiducialGraph(FiducialType::S);
+    refreshFiducialGraph(FiducialType::T);
+
+    // Marker lines + labels for every visible fiducial, drawn in one paint
+    // pass on top of the scatter graphs. Registers itself with the plot,
+    // which takes ownership like it does for the graphs.
+    fidLayer_ = new FiducialLayerPlottable(plot_->xAxis, plot_->yAxis, this);
 
     tabWidget_ = new QTabWidget(central);
     tabWidget_->setTabPosition(QTabWidget::South);
@@ -426,8 +486,25 @@ ECGViewer::ECGViewer(const QVector<double>& t,
     setWindowTitle("ECG Viewer (Qt)");
     this->setStyleSheet(viewerStylesheet());
 
+    // Scrubbing fires valueChanged for every intermediate thumb position;
+    // rendering each one synchronously lets the event queue outrun the frame
+    // time and the view rubber-bands. Coalesce through the frame-paced
+    // scheduler instead: only the latest requested window is ever rendered,
+    // at most once per timer tick.
+    windowUpdateTimer_ = new QTimer(this);
+    windowUpdateTimer_->setInterval(16); // ~one 60 Hz vsync interval
+    connect(windowUpdateTimer_, &QTimer::timeout, this, [this]() {
+        if (pendingStartSample_ < 0) {
+            windowUpdateTimer_->stop();
+            return;
+        }
+        const int startSample = pendingStartSample_;
+        pendingStartSample_ = -1;
+        updateWindow(startSample);
+    });
+
     connect(slider_, &QSlider::valueChanged,
-            this, [this](int value) { updateWindow(value); });
+            this, [this](int value) { requestWindow(value); });
 
     connect(manualInsertButton_, &QPushButton::clicked,
             this, &ECGViewer::onInsertManualFiducial);
@@ -549,6 +626,35 @@ ECGViewer::ECGViewer(const QVector<double>& t,
 
     refreshNotesList();
     updateWindow(0);
+
+    // Build the min/max tile pyramids off the GUI thread; updateWindow()
+    // keeps using direct scans until ready() flips.
+    pyramidBuildThread_ = std::thread([this]() {
+        pyramidClean_.build(vClean_, &artRuns_);
+        pyramidOrig_.build(vOrig_, nullptr);
+    });
+
+    // Start the window prefetcher and seed it with the initial view's
+    // neighbours.
+    prefetchThread_ = std::thread([this]() { prefetchLoop(); });
+    schedulePrefetch(0);
+}
+
+ECGViewer::~ECGViewer()
+{
+    {
+        std::lock_guard<std::mutex> lock(prefetchMutex_);
+        prefetchStop_ = true;
+    }
+    prefetchCv_.notify_all();
+    if (prefetchThread_.joinable())
+        prefetchThread_.join();
+
+    if (pyramidBuildThread_.joinable())
+        pyramidBuildThread_.join();
+
+    if (exportThread_.joinable())
+        exportThread_.join();
 }
 
 } // namespace ECGViewer
@@ -17,7 +17,8 @@
  * - Skips whitespace.
  * - Recognizes the known header keys above.
  * - Skips other header-ish lines quickly when they contain '=' early in the line.
- * - For numeric data, reads the first two floats on a line and ignores the rest.
+ * - For numeric data, reads the first two floats on a line and ignores the
+ *   rest (parse_ecg_file_multi instead parses every value column).
  * - If no numeric rows are found, throws.
  *
  * Outputs:
@@ -30,417 +31,475 @@
  */
 #include <pybind11/pybind11.h>
 #include <pybind11/numpy.h>
+#include <pybind11/stl.h>
 
-#include <algorithm>
-#include <cmath>
-#include <cstdint>
-#include <cstring>
-#include <fstream>
-#include <optional>
-#include <stdexcept>
-#include <string>
-#include <vector>
-
-#if defined(__unix__) || defined(__APPLE__)
-#include <fcntl.h>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
-#endif
-
-#if defined(_WIN32)
-#define NOMINMAX
-#include <windows.h>
-#endif
+#include <atomic>
+#include <filesystem>
+#include <memory>
 
+#include "ParseEcgCore.hpp"
 
 namespace py = pybind11;
 
-struct EcgMeta {
-    std::optional<double> interval_s;
-    std::optional<std::string> channel_title;
-    std::optional<std::string> range;
-};
-
-struct EcgData {
-    std::vector<double> t;
-    std::vector<double> v;
-    std::optional<double> fs;
-    EcgMeta meta;
-};
-
-static inline bool is_space(unsigned char c) {
-    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
-}
+// ---------------------------------------------------------------------------
+// Binary sidecar cache (<file>.ecgbin)
+//
+// After a successful text parse we drop a small binary sidecar next to the
+// source: a fixed 4 KB header (row count, fs/meta, source size+mtime for
+// validation) followed by the raw little-endian float64 t and v arrays.
+// Subsequent opens of an unchanged source mmap the sidecar and hand numpy
+// arrays backed directly by the mapping back to Python -- no parse, no copy.
+// ---------------------------------------------------------------------------
 
-static inline const char *skip_spaces(const char *p, const char *end) {
-    while (p < end && is_space(static_cast<unsigned char>(*p))) ++p;
-    return p;
-}
+static constexpr char kEcgBinMagic[8] = {'E', 'C', 'G', 'B', 'I', 'N', '0', '1'};
+static constexpr std::size_t kEcgBinHeaderBytes = 4096;
 
-static inline const char *skip_to_eol(const char *p, const char *end) {
-    while (p < end && *p != '\n') ++p;
-    if (p < end && *p == '\n') ++p;
-    return p;
+/**
+ * @brief Stat the source file for sidecar validation (size + mtime).
+ */
+static bool stat_source_file(const std::string &path, uint64_t &size, int64_t &mtime) {
+    std::error_code ec;
+    auto sz = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto ft = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    size = static_cast<uint64_t>(sz);
+    mtime = static_cast<int64_t>(ft.time_since_epoch().count());
+    return true;
 }
 
-static inline bool starts_with(const char *p, const char *end, const char *lit) {
-    const std::size_t n = std::strlen(lit);
-    return static_cast<std::size_t>(end - p) >= n && std::memcmp(p, lit, n) == 0;
-}
+// Fixed field offsets inside the 4 KB header block.
+namespace ecgbin {
+constexpr std::size_t kMagic = 0;       // char[8]
+constexpr std::size_t kRows = 8;        // uint64
+constexpr std::size_t kSrcSize = 16;    // uint64
+constexpr std::size_t kSrcMtime = 24;   // int64
+constexpr std::size_t kHasFs = 32;      // uint8
+constexpr std::size_t kHasInterval = 33;// uint8
+constexpr std::size_t kTitleLen = 36;   // uint32
+constexpr std::size_t kRangeLen = 40;   // uint32
+constexpr std::size_t kFs = 48;         // double
+constexpr std::size_t kInterval = 56;   // double
+constexpr std::size_t kStrings = 64;    // title bytes, then range bytes
+} // namespace ecgbin
 
 /**
- * @brief Fast 10^e for small integer exponents.
- *
- * This avoids std::pow for common small exponents (both positive and negative),
- * which is a hot path when parsing many floats with fractional digits/exponents.
+ * @brief Write the sidecar cache for @p src_path. Best-effort: returns false
+ * on any IO problem and the caller simply proceeds without a cache.
  */
-static inline double pow10_i(int e) {
-    static const double pos[] = {
-        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
-        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
-        1e20, 1e21, 1e22
-    };
-    static const double neg[] = {
-        1e0,  1e-1,  1e-2,  1e-3,  1e-4,  1e-5,  1e-6,  1e-7,  1e-8,  1e-9,
-        1e-10, 1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19,
-        1e-20, 1e-21, 1e-22
+static bool write_ecgbin_sidecar(const std::string &src_path, const EcgData &data) {
+    uint64_t src_size = 0;
+    int64_t src_mtime = 0;
+    if (!stat_source_file(src_path, src_size, src_mtime)) return false;
+
+    const std::string &title = data.meta.channel_title ? *data.meta.channel_title : std::string();
+    const std::string &range = data.meta.range ? *data.meta.range : std::string();
+    if (ecgbin::kStrings + title.size() + range.size() > kEcgBinHeaderBytes) return false;
+
+    std::vector<char> header(kEcgBinHeaderBytes, 0);
+    auto put = [&header](std::size_t off, const void *src, std::size_t n) {
+        std::memcpy(header.data() + off, src, n);
     };
 
-    if (e >= 0) {
-        if (e <= 22) return pos[e];
-        return std::pow(10.0, static_cast<double>(e));
+    const uint64_t n_rows = data.t.size();
+    const uint8_t has_fs = data.fs ? 1 : 0;
+    const uint8_t has_interval = data.meta.interval_s ? 1 : 0;
+    const uint32_t title_len = static_cast<uint32_t>(title.size());
+    const uint32_t range_len = static_cast<uint32_t>(range.size());
+    const double fs = data.fs.value_or(0.0);
+    const double interval = data.meta.interval_s.value_or(0.0);
+
+    put(ecgbin::kMagic, kEcgBinMagic, 8);
+    put(ecgbin::kRows, &n_rows, 8);
+    put(ecgbin::kSrcSize, &src_size, 8);
+    put(ecgbin::kSrcMtime, &src_mtime, 8);
+    put(ecgbin::kHasFs, &has_fs, 1);
+    put(ecgbin::kHasInterval, &has_interval, 1);
+    put(ecgbin::kTitleLen, &title_len, 4);
+    put(ecgbin::kRangeLen, &range_len, 4);
+    put(ecgbin::kFs, &fs, 8);
+    put(ecgbin::kInterval, &interval, 8);
+    if (title_len) put(ecgbin::kStrings, title.data(), title_len);
+    if (range_len) put(ecgbin::kStrings + title_len, range.data(), range_len);
+
+    std::ofstream f(src_path + ".ecgbin", std::ios::binary | std::ios::trunc);
+    if (!f.is_open()) return false;
+
+    f.write(header.data(), static_cast<std::streamsize>(header.size()));
+    f.write(reinterpret_cast<const char *>(data.t.data()),
+            static_cast<std::streamsize>(n_rows * sizeof(double)));
+    f.write(reinterpret_cast<const char *>(data.v.data()),
+            static_cast<std::streamsize>(n_rows * sizeof(double)));
+    f.close();
+
+    return f.good();
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/// Shared ownership of a sidecar mapping; unmapped when the last array dies.
+struct SidecarMap {
+    void *map = nullptr;
+    std::size_t len = 0;
+    ~SidecarMap() {
+        if (map) ::munmap(map, len);
     }
+};
+#endif
 
-    int a = -e;
-    if (a <= 22) return neg[a];
-    return std::pow(10.0, static_cast<double>(e));
+/**
+ * @brief Mark a numpy array read-only (mmap'd sidecar data must not be written).
+ */
+static void make_array_readonly(py::array &arr) {
+    py::detail::array_proxy(arr.ptr())->flags &= ~py::detail::npy_api::NPY_ARRAY_WRITEABLE_;
 }
 
 /**
- * @brief Parse a floating-point number from a char buffer.
+ * @brief Try to serve (t, v, fs, meta) from a valid sidecar cache.
  *
- * Accepts:
- * - optional leading whitespace
- * - optional sign
- * - integer digits
- * - optional fractional part
- * - optional exponent (e/E with optional sign)
- *
- * On success:
- * - writes the parsed value to @p out
- * - sets @p next to the first unconsumed character
- * - returns true
- *
- * On failure:
- * - returns false (caller typically skips to end-of-line and continues)
- *
- * Notes:
- * - This is intentionally a permissive, allocation-free parser for speed.
- * - Fractional precision is capped (keeps up to 18 fractional digits) to avoid
- *   overflow in the integer accumulator. Which is sufficient for double precision and
- *   more than accurate enough for the precision of ECG data.
+ * Returns None when there is no sidecar, the sidecar is stale (source
+ * size/mtime mismatch), or it is malformed. On Unix/macOS the arrays are
+ * zero-copy views into the mmapped sidecar; elsewhere the sidecar is read
+ * into fresh vectors, which still skips the text parse.
  */
-static inline bool parse_double(const char *p, const char *end, double &out, const char *&next) {
-    p = skip_spaces(p, end);
-    if (p >= end) return false;
-
-    bool neg = false;
-    if (*p == '+' || *p == '-') {
-        neg = (*p == '-');
-        ++p;
-        if (p >= end) return false;
+static py::object try_load_ecgbin_sidecar(const std::string &src_path) {
+    uint64_t src_size = 0;
+    int64_t src_mtime = 0;
+    if (!stat_source_file(src_path, src_size, src_mtime)) return py::none();
+
+    const std::string side_path = src_path + ".ecgbin";
+
+    char header[kEcgBinHeaderBytes];
+    {
+        std::ifstream f(side_path, std::ios::binary);
+        if (!f.is_open()) return py::none();
+        f.read(header, static_cast<std::streamsize>(kEcgBinHeaderBytes));
+        if (!f.good()) return py::none();
     }
 
-    uint64_t int_part = 0;
-    bool saw_digit = false;
-    while (p < end) {
-        unsigned char c = static_cast<unsigned char>(*p);
-        if (c < '0' || c > '9') break;
-        saw_digit = true;
+    if (std::memcmp(header + ecgbin::kMagic, kEcgBinMagic, 8) != 0) return py::none();
 
-        uint64_t d = static_cast<uint64_t>(c - '0');
-        if (int_part <= (UINT64_MAX - d) / 10) int_part = int_part * 10 + d;
-        ++p;
-    }
+    uint64_t n_rows = 0, cached_size = 0;
+    int64_t cached_mtime = 0;
+    uint8_t has_fs = 0, has_interval = 0;
+    uint32_t title_len = 0, range_len = 0;
+    double fs = 0.0, interval = 0.0;
 
-    uint64_t frac_part = 0;
-    int frac_digits = 0;
-    if (p < end && *p == '.') {
-        ++p;
-        while (p < end) {
-            unsigned char c = static_cast<unsigned char>(*p);
-            if (c < '0' || c > '9') break;
-            saw_digit = true;
-
-            if (frac_digits < 18) {
-                frac_part = frac_part * 10 + static_cast<uint64_t>(c - '0');
-                ++frac_digits;
-            }
-            ++p;
-        }
+    auto get = [&header](std::size_t off, void *dst, std::size_t n) {
+        std::memcpy(dst, header + off, n);
+    };
+    get(ecgbin::kRows, &n_rows, 8);
+    get(ecgbin::kSrcSize, &cached_size, 8);
+    get(ecgbin::kSrcMtime, &cached_mtime, 8);
+    get(ecgbin::kHasFs, &has_fs, 1);
+    get(ecgbin::kHasInterval, &has_interval, 1);
+    get(ecgbin::kTitleLen, &title_len, 4);
+    get(ecgbin::kRangeLen, &range_len, 4);
+    get(ecgbin::kFs, &fs, 8);
+    get(ecgbin::kInterval, &interval, 8);
+
+    if (cached_size != src_size || cached_mtime != src_mtime) return py::none();
+    if (ecgbin::kStrings + static_cast<std::size_t>(title_len) + range_len > kEcgBinHeaderBytes)
+        return py::none();
+
+    const std::size_t expect_len =
+        kEcgBinHeaderBytes + 2 * static_cast<std::size_t>(n_rows) * sizeof(double);
+
+    py::dict meta;
+    meta["interval_s"] = has_interval ? py::object(py::float_(interval)) : py::object(py::none());
+    meta["channel_title"] = title_len
+        ? py::object(py::str(header + ecgbin::kStrings, title_len))
+        : py::object(py::none());
+    meta["range"] = range_len
+        ? py::object(py::str(header + ecgbin::kStrings + title_len, range_len))
+        : py::object(py::none());
+    py::object fs_obj = has_fs ? py::object(py::float_(fs)) : py::object(py::none());
+
+    const py::size_t n = static_cast<py::size_t>(n_rows);
+    const py::size_t stride = static_cast<py::size_t>(sizeof(double));
+
+#if defined(__unix__) || defined(__APPLE__)
+    int fd = ::open(side_path.c_str(), O_RDONLY);
+    if (fd < 0) return py::none();
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) != expect_len) {
+        ::close(fd);
+        return py::none();
     }
 
-    if (!saw_digit) return false;
+    void *map = ::mmap(nullptr, expect_len, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (map == MAP_FAILED) return py::none();
 
-    int exp10 = 0;
-    if (p < end && (*p == 'e' || *p == 'E')) {
-        const char *pe = p + 1;
-        if (pe < end) {
-            bool exp_neg = false;
-            if (*pe == '+' || *pe == '-') {
-                exp_neg = (*pe == '-');
-                ++pe;
-            }
+    auto holder = std::make_shared<SidecarMap>();
+    holder->map = map;
+    holder->len = expect_len;
 
-            int e = 0;
-            bool saw_e = false;
-            while (pe < end) {
-                unsigned char c = static_cast<unsigned char>(*pe);
-                if (c < '0' || c > '9') break;
-                saw_e = true;
-                if (e < 10000) e = e * 10 + static_cast<int>(c - '0');
-                ++pe;
-            }
+    auto make_caps = [&holder]() {
+        return py::capsule(new std::shared_ptr<SidecarMap>(holder), [](void *p) {
+            delete static_cast<std::shared_ptr<SidecarMap> *>(p);
+        });
+    };
 
-            if (saw_e) {
-                exp10 = exp_neg ? -e : e;
-                p = pe;
-            }
-        }
+    char *base = static_cast<char *>(map);
+    double *t_ptr = reinterpret_cast<double *>(base + kEcgBinHeaderBytes);
+    double *v_ptr = t_ptr + n_rows;
+
+    py::array t_arr(
+        py::buffer_info(t_ptr, sizeof(double), py::format_descriptor<double>::format(),
+                        1, { n }, { stride }),
+        make_caps()
+    );
+    py::array v_arr(
+        py::buffer_info(v_ptr, sizeof(double), py::format_descriptor<double>::format(),
+                        1, { n }, { stride }),
+        make_caps()
+    );
+    make_array_readonly(t_arr);
+    make_array_readonly(v_arr);
+
+    return py::make_tuple(t_arr, v_arr, fs_obj, meta);
+#else
+    std::ifstream f(side_path, std::ios::binary);
+    if (!f.is_open()) return py::none();
+
+    f.seekg(0, std::ios::end);
+    if (static_cast<std::size_t>(f.tellg()) != expect_len) return py::none();
+    f.seekg(static_cast<std::streamoff>(kEcgBinHeaderBytes), std::ios::beg);
+
+    auto *t_vec = new std::vector<double>(n_rows);
+    auto *v_vec = new std::vector<double>(n_rows);
+
+    f.read(reinterpret_cast<char *>(t_vec->data()),
+           static_cast<std::streamsize>(n_rows * sizeof(double)));
+    f.read(reinterpret_cast<char *>(v_vec->data()),
+           static_cast<std::streamsize>(n_rows * sizeof(double)));
+    if (!f.good()) {
+        delete t_vec;
+        delete v_vec;
+        return py::none();
     }
 
-    double val = static_cast<double>(int_part);
-    if (frac_digits > 0) val += static_cast<double>(frac_part) * pow10_i(-frac_digits);
-    if (exp10 != 0) val *= pow10_i(exp10);
+    py::capsule t_caps(t_vec, [](void *p) { delete static_cast<std::vector<double> *>(p); });
+    py::capsule v_caps(v_vec, [](void *p) { delete static_cast<std::vector<double> *>(p); });
 
-    out = neg ? -val : val;
-    next = p;
-    return true;
+    py::array t_arr(
+        py::buffer_info(t_vec->data(), sizeof(double), py::format_descriptor<double>::format(),
+                        1, { n }, { stride }),
+        t_caps
+    );
+    py::array v_arr(
+        py::buffer_info(v_vec->data(), sizeof(double), py::format_descriptor<double>::format(),
+                        1, { n }, { stride }),
+        v_caps
+    );
+
+    return py::make_tuple(t_arr, v_arr, fs_obj, meta);
+#endif
 }
 
 /**
- * @brief Compute the median of a vector in-place.
- *
- * Uses std::nth_element and may reorder elements.
- * Returns 0.0 for an empty vector.
+ * @brief Convert optional<double> to a Python object (float or None).
  */
-static double median_in_place(std::vector<double> &v) {
-    std::size_t n = v.size();
-    if (n == 0) return 0.0;
-
-    std::size_t mid = n / 2;
-    std::nth_element(v.begin(), v.begin() + static_cast<long>(mid), v.end());
-    double m = v[mid];
-    if (n % 2 == 1) return m;
-
-    auto max_it = std::max_element(v.begin(), v.begin() + static_cast<long>(mid));
-    return 0.5 * (m + *max_it);
+static py::object opt_to_py(const std::optional<double> &v) {
+    if (v) {
+        return py::float_(*v);
+    }
+    return py::none();
 }
 
-
 /**
- * @brief Read the remainder of the current line as trimmed text.
- *
- * Skips leading whitespace, stops at newline, and trims trailing whitespace.
- * Returns nullopt if the line is empty after trimming.
+ * @brief Convert optional<string> to a Python object (str or None).
  */
-static inline std::optional<std::string> read_trimmed_eol_text(const char *&p, const char *end) {
-    p = skip_spaces(p, end);
-    const char *s = p;
-    while (p < end && *p != '\n' && *p != '\r') ++p;
-
-    const char *e = p;
-    while (e > s && is_space(static_cast<unsigned char>(e[-1]))) --e;
+static py::object opt_to_py(const std::optional<std::string> &v) {
+    if (v) {
+        return py::str(*v);
+    }
+    return py::none();
+}
 
-    if (e <= s) return std::nullopt;
-    return std::string(s, e);
+/**
+ * @brief Convert a perf-counter snapshot into {name: {count, mean, ...}}.
+ */
+static py::dict perf_snapshot_to_dict(const std::map<std::string, ParsePerf::Summary> &snap) {
+    py::dict out;
+    for (const auto &entry : snap) {
+        py::dict s;
+        s["count"] = entry.second.count;
+        s["mean"] = entry.second.mean;
+        s["p50"] = entry.second.p50;
+        s["p95"] = entry.second.p95;
+        s["max"] = entry.second.max;
+        out[py::str(entry.first)] = s;
+    }
+    return out;
 }
 
 /**
- * @brief Parse ECG content already loaded into memory.
- *
- * Reads line-by-line from a raw buffer. Header fields populate EcgMeta.
- * Numeric rows append to t and v.
+ * @brief Wrap a heap-allocated vector as a numpy float64 array without copying.
  *
- * Sampling frequency (fs) inference:
- * - If Interval= is present and > 0, fs = 1 / interval.
- * - Else, if at least 2 timestamps exist, compute dt series and use fs = 1 / median(dt).
- *
- * Throws std::runtime_error if no numeric rows are found.
+ * A capsule owns the vector and frees it when the array is garbage-collected.
  */
-static EcgData parse_ecg_bytes(const char *buf, std::size_t len) {
-    EcgData result;
-
-    const char *p = buf;
-    const char *end = buf + len;
-
-    std::size_t est_rows = len / 32;
-    if (est_rows < 256'000) est_rows = 256'000;
-    if (est_rows > 50'000'000) est_rows = 50'000'000;
-    result.t.reserve(est_rows);
-    result.v.reserve(est_rows);
-
-    while (p < end) {
-        p = skip_spaces(p, end);
-        if (p >= end) break;
-
-        if (starts_with(p, end, "Interval=")) {
-            p += 9;
-            double interval = 0.0;
-            const char *next = nullptr;
-            if (parse_double(p, end, interval, next)) result.meta.interval_s = interval;
-            p = skip_to_eol(p, end);
-            continue;
-        }
+static py::array vector_to_array(std::vector<double> *vec) {
+    py::capsule caps(vec, [](void *p) { delete static_cast<std::vector<double> *>(p); });
+    py::size_t n = static_cast<py::size_t>(vec->size());
+    return py::array(
+        py::buffer_info(
+            vec->data(), sizeof(double), py::format_descriptor<double>::format(),
+            1, { n }, { static_cast<py::size_t>(sizeof(double)) }
+        ),
+        caps
+    );
+}
 
-        if (starts_with(p, end, "ChannelTitle=")) {
-            p += 13;
-            if (auto s = read_trimmed_eol_text(p, end)) result.meta.channel_title = std::move(*s);
-            p = skip_to_eol(p, end);
-            continue;
-        }
+// ---------------------------------------------------------------------------
+// Streaming parse (bounded memory)
+//
+// parse_ecg_stream() returns an iterator that parses the source incrementally
+// and yields fixed-size (t, v) numpy chunks, so peak memory is bounded by
+// chunk_rows regardless of file length. On Unix/macOS the source stays
+// memory-mapped and the kernel pages it in and out as the cursor advances;
+// elsewhere the file is read in blocks with a partial-line carry buffer.
+// ---------------------------------------------------------------------------
+
+class EcgStreamReader {
+public:
+    EcgStreamReader(const std::string &path, std::size_t chunk_rows)
+        : chunk_rows_(chunk_rows == 0 ? 1 : chunk_rows) {
+#if defined(__unix__) || defined(__APPLE__)
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open ECG file: " + path);
 
-        if (starts_with(p, end, "Range=")) {
-            p += 6;
-            if (auto s = read_trimmed_eol_text(p, end)) result.meta.range = std::move(*s);
-            p = skip_to_eol(p, end);
-            continue;
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat ECG file: " + path);
         }
 
-        // Fast-skip any header-ish line that contains '=' before whitespace.
-        {
-            const char *q = p;
-            while (q < end && !is_space(static_cast<unsigned char>(*q)) && *q != '\n' && *q != '\r') {
-                if (*q == '=') {
-                    p = skip_to_eol(p, end);
-                    goto continue_outer;
-                }
-                ++q;
-            }
+        if (st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("ECG file is empty: " + path);
         }
 
-        // Numeric row: two floats
-        {
-            double t_val = 0.0;
-            const char *p0_end = nullptr;
-            if (!parse_double(p, end, t_val, p0_end)) {
-                p = skip_to_eol(p, end);
-                goto continue_outer;
-            }
-
-            double v_val = 0.0;
-            const char *p1_end = nullptr;
-            if (!parse_double(p0_end, end, v_val, p1_end)) {
-                p = skip_to_eol(p, end);
-                goto continue_outer;
-            }
-
-            result.t.push_back(t_val);
-            result.v.push_back(v_val);
-            p = skip_to_eol(p1_end, end);
+        map_len_ = static_cast<std::size_t>(st.st_size);
+        map_ = ::mmap(nullptr, map_len_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map_ == MAP_FAILED) {
+            map_ = nullptr;
+            throw std::runtime_error("mmap failed for ECG file: " + path);
         }
 
-    continue_outer:
-        continue;
+        cur_ = static_cast<const char *>(map_);
+        end_ = cur_ + map_len_;
+#else
+        f_.open(path, std::ios::binary);
+        if (!f_.is_open()) throw std::runtime_error("Could not open ECG file: " + path);
+#endif
     }
 
-    if (result.t.empty()) throw std::runtime_error("No numeric data rows were found.");
-
-    if (result.meta.interval_s && *result.meta.interval_s > 0.0) {
-        result.fs = 1.0 / *result.meta.interval_s;
-    } else if (result.t.size() > 1) {
-        std::vector<double> dt;
-        dt.reserve(result.t.size() - 1);
-        for (std::size_t i = 1; i < result.t.size(); ++i) dt.push_back(result.t[i] - result.t[i - 1]);
+    EcgStreamReader(const EcgStreamReader &) = delete;
+    EcgStreamReader &operator=(const EcgStreamReader &) = delete;
 
-        double med_dt = median_in_place(dt);
-        if (med_dt > 0.0 && std::isfinite(med_dt)) result.fs = 1.0 / med_dt;
+    ~EcgStreamReader() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (map_) ::munmap(map_, map_len_);
+#endif
     }
 
-    return result;
-}
-
+    /**
+     * @brief Parse and return the next (t, v) chunk.
+     *
+     * Releases the GIL while parsing. Raises StopIteration once the source
+     * yields no further numeric rows.
+     */
+    py::tuple next() {
+        auto *t_vec = new std::vector<double>();
+        auto *v_vec = new std::vector<double>();
+        try {
+            py::gil_scoped_release release;
+            t_vec->reserve(chunk_rows_);
+            v_vec->reserve(chunk_rows_);
+            fill_chunk(*t_vec, *v_vec);
+        } catch (...) {
+            delete t_vec;
+            delete v_vec;
+            throw;
+        }
 
-/**
- * @brief Parse an ECG file from disk (native C++).
- *
- * Uses memory-mapped IO on Unix/macOS and Windows to avoid an extra copy and reduce
- * peak memory usage. Falls back to reading the file into a std::string buffer on
- * other platforms.
- *
- * Throws std::runtime_error on IO errors, empty files, or parse failures.
- */
-static EcgData parse_ecg_file_cpp(const std::string &path) {
-#if defined(__unix__) || defined(__APPLE__)
-    int fd = ::open(path.c_str(), O_RDONLY);
-    if (fd < 0) throw std::runtime_error("Could not open ECG file: " + path);
+        if (t_vec->empty()) {
+            delete t_vec;
+            delete v_vec;
+            throw py::stop_iteration();
+        }
 
-    struct stat st;
-    if (::fstat(fd, &st) != 0) {
-        ::close(fd);
-        throw std::runtime_error("Could not stat ECG file: " + path);
+        py::array t_arr = vector_to_array(t_vec);
+        py::array v_arr = vector_to_array(v_vec);
+        return py::make_tuple(t_arr, v_arr);
     }
 
-    if (st.st_size <= 0) {
-        ::close(fd);
-        throw std::runtime_error("ECG file is empty: " + path);
+    /**
+     * @brief Header fields seen so far.
+     *
+     * Headers sit at the top of real exports, so the dict is complete after
+     * the first chunk has been consumed.
+     */
+    py::dict meta() const {
+        py::dict d;
+        d["interval_s"] = opt_to_py(meta_.interval_s);
+        d["channel_title"] = opt_to_py(meta_.channel_title);
+        d["range"] = opt_to_py(meta_.range);
+        return d;
     }
 
-    std::size_t len = static_cast<std::size_t>(st.st_size);
-    void *map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
-    ::close(fd);
-    if (map == MAP_FAILED) throw std::runtime_error("mmap failed for ECG file: " + path);
-
-    try {
-        EcgData data = parse_ecg_bytes(static_cast<const char *>(map), len);
-        ::munmap(map, len);
-        return data;
-    } catch (...) {
-        ::munmap(map, len);
-        throw;
-    }
+private:
+    void fill_chunk(std::vector<double> &t, std::vector<double> &v) {
+#if defined(__unix__) || defined(__APPLE__)
+        cur_ = parse_ecg_chunk(cur_, end_, t, v, meta_, chunk_rows_);
 #else
-    // Fallback read file into memory, then parse.
-    std::ifstream f(path, std::ios::binary);
-    if (!f.is_open()) {
-        throw std::runtime_error("Could not open ECG file: " + path);
-    }
+        constexpr std::size_t kReadBlockBytes = 8u << 20;
+
+        while (t.size() < chunk_rows_) {
+            if (!eof_) {
+                const std::size_t old = buf_.size();
+                buf_.resize(old + kReadBlockBytes);
+                f_.read(&buf_[old], static_cast<std::streamsize>(kReadBlockBytes));
+                const std::size_t got = static_cast<std::size_t>(f_.gcount());
+                buf_.resize(old + got);
+                if (got == 0) eof_ = true;
+            }
+            if (buf_.empty()) break;
+
+            const char *b = buf_.data();
+            const char *bend = b + buf_.size();
+            const char *parse_end = bend;
+            if (!eof_) {
+                // Only hand whole lines to the parser; the partial tail stays
+                // in the carry buffer for the next read.
+                while (parse_end > b && parse_end[-1] != '\n') --parse_end;
+                if (parse_end == b) continue;
+            }
 
-    f.seekg(0, std::ios::end);
-    std::streampos endp = f.tellg();
-    if (endp <= 0) {
-        throw std::runtime_error("ECG file is empty: " + path);
+            const char *stop = parse_ecg_chunk(b, parse_end, t, v, meta_,
+                                               chunk_rows_ - t.size());
+            buf_.erase(0, static_cast<std::size_t>(stop - b));
+        }
+#endif
     }
-    f.seekg(0, std::ios::beg);
 
-    std::string buf;
-    buf.resize(static_cast<std::size_t>(endp));
-    f.read(&buf[0], static_cast<std::streamsize>(buf.size()));
+    std::size_t chunk_rows_;
+    EcgMeta meta_;
 
-    return parse_ecg_bytes(buf.data(), buf.size());
+#if defined(__unix__) || defined(__APPLE__)
+    void *map_ = nullptr;
+    std::size_t map_len_ = 0;
+    const char *cur_ = nullptr;
+    const char *end_ = nullptr;
+#else
+    std::ifstream f_;
+    std::string buf_; // unconsumed bytes, always starting at a line boundary
+    bool eof_ = false;
 #endif
-}
-
-/**
- * @brief Convert optional<double> to a Python object (float or None).
- */
-static py::object opt_to_py(const std::optional<double> &v) {
-    if (v) {
-        return py::float_(*v);
-    }
-    return py::none();
-}
-
-/**
- * @brief Convert optional<string> to a Python object (str or None).
- */
-static py::object opt_to_py(const std::optional<std::string> &v) {
-    if (v) {
-        return py::str(*v);
-    }
-    return py::none();
-}
+};
 
 /**
  * @brief Python-facing wrapper around parse_ecg_file_cpp.
@@ -452,13 +511,48 @@ static py::object opt_to_py(const std::optional<std::string> &v) {
  *
  * Return value:
  *   (t_arr, v_arr, fs_or_None, meta_dict)
+ *
+ * With implicit_time=True the first element is a plain float t0 instead of
+ * an array: only the value column is converted and the time axis is implied
+ * by t0 + i/fs. This requires the export to carry Interval= (the fs source);
+ * the sidecar cache does not apply in this mode.
  */
-static py::tuple parse_ecg_file_py(const std::string &path) {
+static py::tuple parse_ecg_file_py(const std::string &path, int threads, bool cache,
+                                   bool implicit_time) {
+    if (cache && !implicit_time) {
+        const auto t_cache0 = std::chrono::steady_clock::now();
+        py::object cached = try_load_ecgbin_sidecar(path);
+        if (!cached.is_none()) {
+            ParsePerf::instance().record("parse.sidecar_ms", ms_since(t_cache0));
+            return py::cast<py::tuple>(cached);
+        }
+    }
+
     EcgData data = [&]() {
         py::gil_scoped_release release;
-        return parse_ecg_file_cpp(path);
+        EcgData parsed = parse_ecg_file_cpp(path, threads, !implicit_time);
+        if (cache && !implicit_time) write_ecgbin_sidecar(path, parsed);
+        return parsed;
     }();
 
+    if (implicit_time) {
+        if (!data.meta.interval_s || *data.meta.interval_s <= 0.0)
+            throw std::runtime_error(
+                "implicit_time requires an Interval= header; re-parse with "
+                "implicit_time=False for this file: " + path);
+
+        auto *v_vec = new std::vector<double>(std::move(data.v));
+        py::array v_arr = vector_to_array(v_vec);
+
+        py::dict meta;
+        meta["interval_s"] = opt_to_py(data.meta.interval_s);
+        meta["channel_title"] = opt_to_py(data.meta.channel_title);
+        meta["range"] = opt_to_py(data.meta.range);
+
+        return py::make_tuple(py::float_(data.t0.value_or(0.0)), v_arr,
+                              opt_to_py(data.fs), meta);
+    }
+
     auto *t_vec = new std::vector<double>(std::move(data.t));
     auto *v_vec = new std::vector<double>(std::move(data.v));
 
@@ -469,23 +563,8 @@ static py::tuple parse_ecg_file_py(const std::string &path) {
         throw std::runtime_error("Internal error: t and v sizes differ.");
     }
 
-    py::capsule t_caps(t_vec, [](void *p) { delete static_cast<std::vector<double> *>(p); });
-    py::capsule v_caps(v_vec, [](void *p) { delete static_cast<std::vector<double> *>(p); });
-
-    py::array t_arr(
-        py::buffer_info(
-            t_vec->data(), sizeof(double), py::format_descriptor<double>::format(),
-            1, { n }, { static_cast<py::size_t>(sizeof(double)) }
-        ),
-        t_caps
-    );
-    py::array v_arr(
-        py::buffer_info(
-            v_vec->data(), sizeof(double), py::format_descriptor<double>::format(),
-            1, { n }, { static_cast<py::size_t>(sizeof(double)) }
-        ),
-        v_caps
-    );
+    py::array t_arr = vector_to_array(t_vec);
+    py::array v_arr = vector_to_array(v_vec);
 
     py::dict meta;
     meta["interval_s"] = opt_to_py(data.meta.interval_s);
@@ -495,9 +574,121 @@ static py::tuple parse_ecg_file_py(const std::string &path) {
     return py::make_tuple(t_arr, v_arr, opt_to_py(data.fs), meta);
 }
 
+/**
+ * @brief Parse many files concurrently on a C++ thread pool.
+ *
+ * Workers pull paths off a shared atomic counter and run the normal
+ * mmap-and-parse path (parse_ecg_file_cpp, single-threaded per file: the pool
+ * supplies the parallelism). The GIL is released for the whole batch and
+ * re-acquired only to wrap the finished vectors as numpy arrays, so a
+ * 16-core box parses 16 recordings at once with no pickling or subprocess
+ * copies.
+ *
+ * Results come back as a list of (t, v, fs, meta) tuples in input order.
+ * Failures are collected per file while the batch runs to completion; the
+ * first failure is then raised as RuntimeError.
+ */
+static py::list parse_ecg_files_py(const std::vector<std::string> &paths, int max_workers) {
+    const std::size_t n = paths.size();
+    std::vector<EcgData> results(n);
+    std::vector<std::string> errors(n);
+
+    if (n > 0) {
+        py::gil_scoped_release release;
+
+        unsigned n_workers = max_workers <= 0 ? std::thread::hardware_concurrency()
+                                              : static_cast<unsigned>(max_workers);
+        if (n_workers == 0) n_workers = 1;
+        n_workers = static_cast<unsigned>(std::min<std::size_t>(n_workers, n));
+
+        std::atomic<std::size_t> next{0};
+        std::vector<std::thread> workers;
+        workers.reserve(n_workers);
+        for (unsigned w = 0; w < n_workers; ++w) {
+            workers.emplace_back([&]() {
+                for (;;) {
+                    const std::size_t idx = next.fetch_add(1);
+                    if (idx >= n) return;
+                    try {
+                        results[idx] = parse_ecg_file_cpp(paths[idx], 1);
+                    } catch (const std::exception &e) {
+                        errors[idx] = e.what();
+                    }
+                }
+            });
+        }
+        for (auto &w : workers) w.join();
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!errors[i].empty())
+            throw std::runtime_error(paths[i] + ": " + errors[i]);
+    }
+
+    py::list out;
+    for (std::size_t i = 0; i < n; ++i) {
+        auto *t_vec = new std::vector<double>(std::move(results[i].t));
+        auto *v_vec = new std::vector<double>(std::move(results[i].v));
+        py::array t_arr = vector_to_array(t_vec);
+        py::array v_arr = vector_to_array(v_vec);
+
+        py::dict meta;
+        meta["interval_s"] = opt_to_py(results[i].meta.interval_s);
+        meta["channel_title"] = opt_to_py(results[i].meta.channel_title);
+        meta["range"] = opt_to_py(results[i].meta.range);
+
+        out.append(py::make_tuple(t_arr, v_arr, opt_to_py(results[i].fs), meta));
+    }
+    return out;
+}
+
+/**
+ * @brief Python-facing wrapper around parse_ecg_file_multi_cpp.
+ *
+ * Releases the GIL for the IO + parse and wraps each channel's vector as a
+ * capsule-backed numpy array, so an 8-channel record costs one pass over the
+ * file and no copies on the way out.
+ *
+ * Return value:
+ *   (t_arr, [ch0_arr, ch1_arr, ...], fs_or_None, meta_dict)
+ *
+ * meta_dict carries the usual interval_s / channel_title / range plus
+ * channel_titles: the ChannelTitle= line split per channel (tab separated in
+ * LabChart exports), or an empty list when the header is absent.
+ */
+static py::tuple parse_ecg_file_multi_py(const std::string &path, int threads,
+                                         std::size_t n_channels) {
+    EcgMultiData data = [&]() {
+        py::gil_scoped_release release;
+        return parse_ecg_file_multi_cpp(path, threads, n_channels);
+    }();
+
+    auto *t_vec = new std::vector<double>(std::move(data.t));
+    py::array t_arr = vector_to_array(t_vec);
+
+    py::list channels;
+    for (auto &ch : data.channels) {
+        auto *ch_vec = new std::vector<double>(std::move(ch));
+        channels.append(vector_to_array(ch_vec));
+    }
+
+    py::list titles;
+    for (const auto &title : data.channel_titles) titles.append(py::str(title));
+
+    py::dict meta;
+    meta["interval_s"] = opt_to_py(data.meta.interval_s);
+    meta["channel_title"] = opt_to_py(data.meta.channel_title);
+    meta["range"] = opt_to_py(data.meta.range);
+    meta["channel_titles"] = titles;
+
+    return py::make_tuple(t_arr, channels, opt_to_py(data.fs), meta);
+}
+
 PYBIND11_MODULE(parseECG, m) {
     m.doc() = "ECG text file parser (C++ implementation, optimized)";
-    m.def("parse_ecg_file", &parse_ecg_file_py, py::arg("path"), R"pbdoc(
+    m.def("parse_ecg_file", &parse_ecg_file_py,
+          py::arg("path"), py::arg("threads") = 1, py::arg("cache") = true,
+          py::arg("implicit_time") = false, R"pbdoc(
 Parse an ECG text file into (t, v, fs, meta).
 
 Optimized parser for LabChart-style exports:
@@ -505,10 +696,113 @@ Optimized parser for LabChart-style exports:
 - Numeric rows: <time> <value> (whitespace separated)
 - Skips other headers quickly
 
+Args:
+    path: Path to the text export.
+    threads: Parse worker threads (1 = single-threaded, 0 = hardware concurrency).
+        Large files are split on newline boundaries and parsed per-chunk.
+    cache: Maintain a <path>.ecgbin binary sidecar. The first successful parse
+        writes it; later opens of an unchanged source (same size and mtime)
+        mmap the sidecar and return read-only arrays backed by the mapping,
+        skipping the text parse entirely.
+    implicit_time: Skip materializing the time column. Returns t0 (float)
+        instead of a t array; timestamps are implied by t0 + i/fs. Requires
+        an Interval= header (raises otherwise), halves parse work and output
+        memory. show_ecg_viewer accepts the scalar t0 form directly. The
+        sidecar cache does not apply in this mode.
+
 Returns:
-    t: numpy.ndarray float64
+    t: numpy.ndarray float64 (or float t0 when implicit_time=True)
     v: numpy.ndarray float64
     fs: float or None
     meta: dict
 )pbdoc");
+
+    m.def("parse_ecg_files", &parse_ecg_files_py,
+          py::arg("paths"), py::arg("max_workers") = 0, R"pbdoc(
+Parse many ECG text files concurrently.
+
+A C++ thread pool mmaps and parses the files with the GIL released; each
+file runs the normal single-file parser, and the pool supplies the
+parallelism (one file per core). The GIL is re-acquired only to wrap the
+finished arrays, so batch jobs need neither Python threading nor
+multiprocessing pickling.
+
+Args:
+    paths: List of text export paths.
+    max_workers: Pool size; 0 (default) uses hardware concurrency.
+
+Returns:
+    List of (t, v, fs, meta) tuples in input order. If any file fails the
+    whole batch still runs, then the first failure is raised as
+    RuntimeError.
+)pbdoc");
+
+    m.def("parse_ecg_file_multi", &parse_ecg_file_multi_py,
+          py::arg("path"), py::arg("threads") = 1, py::arg("n_channels") = 0, R"pbdoc(
+Parse a multi-channel ECG text file into (t, channels, fs, meta).
+
+Data rows carry <time> followed by one value per channel (whitespace
+separated). Every value column is parsed into its own contiguous float64
+array in a single pass over the file; with threads > 1 (or 0 for hardware
+concurrency) the file is split on newline boundaries and parsed in
+parallel, so an 8-channel file costs roughly one parse, not eight.
+
+Args:
+    path: Path to the text export.
+    threads: Parse worker threads (1 = single-threaded, 0 = hardware concurrency).
+    n_channels: Value columns per row; 0 (default) detects the count from
+        the first numeric row. Rows with fewer columns are skipped.
+
+Returns:
+    t: numpy.ndarray float64
+    channels: list of numpy.ndarray float64, one per value column
+    fs: float or None
+    meta: dict; includes channel_titles, the ChannelTitle= header split
+        into one title per channel (empty list when absent)
+)pbdoc");
+
+    py::class_<EcgStreamReader>(m, "EcgStream",
+                                "Iterator of (t, v) numpy chunks; see parse_ecg_stream().")
+        .def("__iter__",
+             [](EcgStreamReader &self) -> EcgStreamReader & { return self; },
+             py::return_value_policy::reference_internal)
+        .def("__next__", &EcgStreamReader::next)
+        .def_property_readonly("meta", &EcgStreamReader::meta,
+                               "Header fields seen so far (complete after the first chunk).");
+
+    m.def("parse_ecg_stream",
+          [](const std::string &path, std::size_t chunk_rows) {
+              return std::make_unique<EcgStreamReader>(path, chunk_rows);
+          },
+          py::arg("path"), py::arg("chunk_rows") = 1'000'000, R"pbdoc(
+Parse an ECG text file incrementally with bounded memory.
+
+Returns an iterator yielding (t, v) numpy float64 chunks of at most
+chunk_rows rows each. The source is never materialized whole: on
+Unix/macOS it stays memory-mapped and pages in as the parse advances,
+elsewhere it is read in blocks. Use this for files too large for
+parse_ecg_file.
+
+Args:
+    path: Path to the text export.
+    chunk_rows: Maximum rows per yielded chunk.
+
+Yields:
+    (t, v): numpy.ndarray float64 pairs.
+)pbdoc");
+
+    m.def("get_perf_stats",
+          []() { return perf_snapshot_to_dict(ParsePerf::instance().snapshot()); },
+          R"pbdoc(
+Snapshot of the module's performance counters.
+
+Returns a dict mapping counter name (parse.io_ms, parse.parse_ms,
+parse.sidecar_ms, parse.rows, parse.bytes) to a dict with count, mean,
+p50, p95 and max over all samples recorded since startup or the last
+reset_perf_stats() call.
+)pbdoc");
+
+    m.def("reset_perf_stats",
+          []() { ParsePerf::instance().reset(); },
+          "Clear all recorded performance counters.");
 }
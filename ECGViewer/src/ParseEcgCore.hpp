@@ -0,0 +1,1433 @@
+/**
+ * @file ParseEcgCore.hpp
+ * @brief Pure C++ core of the ECG text parser (no Python dependencies).
+ *
+ * Everything from byte-level scanning (find_eol, parse_double and its SWAR
+ * fast path) up to the whole-file entry points (parse_ecg_bytes,
+ * parse_ecg_file_cpp) lives here so it can be included both by the pybind11
+ * module (ParseEcg.cpp) and by standalone tools such as the bench_parseECG
+ * microbenchmark harness. Functions are static: each including translation
+ * unit gets its own copy, which is fine for the two small consumers.
+ *
+ * See ParseEcg.cpp for the expected input format and parsing behavior.
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+// Optional gzip input support; the build defines ECG_HAVE_ZLIB when zlib was
+// found. Without it, gzip files are detected and rejected with a clear error.
+#if defined(ECG_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+
+// Vectorized line scanning: SSE2 is baseline on x86-64, AVX2 when the build
+// enables it. Non-x86 targets use the scalar fallbacks below.
+#if defined(__AVX2__)
+#define ECG_PARSE_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ECG_PARSE_SSE2 1
+#endif
+#if defined(ECG_PARSE_SSE2) || defined(ECG_PARSE_AVX2)
+#include <immintrin.h>
+#endif
+
+struct EcgMeta {
+    std::optional<double> interval_s;
+    std::optional<std::string> channel_title;
+    std::optional<std::string> range;
+};
+
+struct EcgData {
+    std::vector<double> t;
+    std::vector<double> v;
+    std::optional<double> fs;
+    std::optional<double> t0; // first timestamp; set in value-only mode where t stays empty
+    EcgMeta meta;
+};
+
+/// Result of a multi-channel parse: one contiguous array per value column.
+struct EcgMultiData {
+    std::vector<double> t;
+    std::vector<std::vector<double>> channels;
+    std::vector<std::string> channel_titles; // split from ChannelTitle=, may be shorter than channels
+    std::optional<double> fs;
+    EcgMeta meta;
+};
+
+/**
+ * @brief Process-wide parse-phase counters behind get_perf_stats().
+ *
+ * Named sample series (phase timings in milliseconds, rows/bytes per parse)
+ * summarized on demand as count / mean / p50 / p95 / max. Recording is a
+ * mutex-guarded push_back; the mutex matters because parse calls may run with
+ * the GIL released on multiple Python threads.
+ */
+class ParsePerf {
+public:
+    struct Summary {
+        std::size_t count = 0;
+        double mean = 0.0;
+        double p50 = 0.0;
+        double p95 = 0.0;
+        double max = 0.0;
+    };
+
+    static ParsePerf &instance() {
+        static ParsePerf stats;
+        return stats;
+    }
+
+    void record(const char *name, double value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        series_[name].push_back(value);
+    }
+
+    std::map<std::string, Summary> snapshot() const {
+        std::map<std::string, std::vector<double>> copy;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            copy = series_;
+        }
+
+        std::map<std::string, Summary> out;
+        for (auto &entry : copy) {
+            std::vector<double> &samples = entry.second;
+            if (samples.empty()) continue;
+
+            Summary s;
+            s.count = samples.size();
+
+            double sum = 0.0;
+            for (double x : samples) sum += x;
+            s.mean = sum / static_cast<double>(samples.size());
+
+            auto quantile = [&samples](double q) {
+                const std::size_t idx = static_cast<std::size_t>(
+                    q * static_cast<double>(samples.size() - 1));
+                std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+                return samples[idx];
+            };
+            s.p50 = quantile(0.50);
+            s.p95 = quantile(0.95);
+            s.max = *std::max_element(samples.begin(), samples.end());
+
+            out[entry.first] = s;
+        }
+        return out;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        series_.clear();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::map<std::string, std::vector<double>> series_;
+};
+
+/// Milliseconds elapsed since @p t0.
+static inline double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - t0).count();
+}
+
+static inline bool is_space(unsigned char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v';
+}
+
+static inline const char *skip_spaces(const char *p, const char *end) {
+    while (p < end && is_space(static_cast<unsigned char>(*p))) ++p;
+    return p;
+}
+
+/**
+ * @brief Find the next '\n' at or after @p p, scanning 16-32 bytes per step.
+ *
+ * Returns @p end if the buffer has no further newline. The SIMD paths are a
+ * plain memchr-style compare-and-movemask; the scalar tail/fallback is the
+ * original byte loop, so behavior is identical on every target.
+ */
+static inline const char *find_eol(const char *p, const char *end) {
+#if defined(ECG_PARSE_AVX2)
+    const __m256i nl32 = _mm256_set1_epi8('\n');
+    while (end - p >= 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        unsigned mask = static_cast<unsigned>(
+            _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl32)));
+        if (mask != 0) return p + __builtin_ctz(mask);
+        p += 32;
+    }
+#endif
+#if defined(ECG_PARSE_SSE2)
+    const __m128i nl16 = _mm_set1_epi8('\n');
+    while (end - p >= 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        unsigned mask = static_cast<unsigned>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl16)));
+        if (mask != 0) {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward(&bit, mask);
+            return p + bit;
+#else
+            return p + __builtin_ctz(mask);
+#endif
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && *p != '\n') ++p;
+    return p;
+}
+
+static inline const char *skip_to_eol(const char *p, const char *end) {
+    p = find_eol(p, end);
+    if (p < end && *p == '\n') ++p;
+    return p;
+}
+
+/**
+ * @brief True if the 8 bytes in @p chars are all ASCII digits.
+ */
+static inline bool is_made_of_eight_digits(uint64_t chars) {
+    return (((chars & 0xF0F0F0F0F0F0F0F0ULL) |
+             (((chars + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+            0x3333333333333333ULL);
+}
+
+/**
+ * @brief Convert 8 ASCII digits (little-endian in @p chars) to their value.
+ *
+ * SWAR reduction: pairs, then 4-digit groups, then the full 8-digit value,
+ * using two multiplies instead of eight. Caller must have verified the bytes
+ * with is_made_of_eight_digits().
+ */
+static inline uint32_t parse_eight_digits(uint64_t chars) {
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 0x000F424000000064ULL; // 100 + (1000000 << 32)
+    const uint64_t mul2 = 0x0000271000000001ULL; // 1 + (10000 << 32)
+    chars -= 0x3030303030303030ULL;
+    chars = (chars * 10) + (chars >> 8); // adjacent digit pairs
+    chars = (((chars & mask) * mul1) + (((chars >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(chars);
+}
+
+/**
+ * @brief Consume a run of ASCII digits, eight at a time where possible.
+ *
+ * Accumulates into @p acc (decimal append) and counts consumed digits in
+ * @p n_digits. Stops at the first non-digit or when the accumulator would
+ * overflow a uint64 (matching the saturation behavior of parse_double).
+ */
+static inline const char *parse_digit_run(const char *p, const char *end,
+                                          uint64_t &acc, int &n_digits) {
+    // 8-digit blocks: safe while acc stays below 2^64 / 1e8 ~ 1.8e11, i.e.
+    // well within any fixed-format ECG column.
+    while (end - p >= 8 && acc < 100'000'000'000ULL) {
+        uint64_t chars;
+        std::memcpy(&chars, p, 8);
+        if (!is_made_of_eight_digits(chars)) break;
+        acc = acc * 100'000'000ULL + parse_eight_digits(chars);
+        n_digits += 8;
+        p += 8;
+    }
+
+    while (p < end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c < '0' || c > '9') break;
+        uint64_t d = static_cast<uint64_t>(c - '0');
+        if (acc <= (UINT64_MAX - d) / 10) acc = acc * 10 + d;
+        ++n_digits;
+        ++p;
+    }
+    return p;
+}
+
+
+static inline bool starts_with(const char *p, const char *end, const char *lit) {
+    const std::size_t n = std::strlen(lit);
+    return static_cast<std::size_t>(end - p) >= n && std::memcmp(p, lit, n) == 0;
+}
+
+/**
+ * @brief Fast 10^e for small integer exponents.
+ *
+ * This avoids std::pow for common small exponents (both positive and negative),
+ * which is a hot path when parsing many floats with fractional digits/exponents.
+ */
+static inline double pow10_i(int e) {
+    static const double pos[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+        1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+        1e20, 1e21, 1e22
+    };
+    static const double neg[] = {
+        1e0,  1e-1,  1e-2,  1e-3,  1e-4,  1e-5,  1e-6,  1e-7,  1e-8,  1e-9,
+        1e-10, 1e-11, 1e-12, 1e-13, 1e-14, 1e-15, 1e-16, 1e-17, 1e-18, 1e-19,
+        1e-20, 1e-21, 1e-22
+    };
+
+    if (e >= 0) {
+        if (e <= 22) return pos[e];
+        return std::pow(10.0, static_cast<double>(e));
+    }
+
+    int a = -e;
+    if (a <= 22) return neg[a];
+    return std::pow(10.0, static_cast<double>(e));
+}
+
+/**
+ * @brief Parse a floating-point number from a char buffer.
+ *
+ * Accepts:
+ * - optional leading whitespace
+ * - optional sign
+ * - integer digits
+ * - optional fractional part
+ * - optional exponent (e/E with optional sign)
+ *
+ * On success:
+ * - writes the parsed value to @p out
+ * - sets @p next to the first unconsumed character
+ * - returns true
+ *
+ * On failure:
+ * - returns false (caller typically skips to end-of-line and continues)
+ *
+ * Notes:
+ * - This is intentionally a permissive, allocation-free parser for speed.
+ * - Fractional precision is capped (keeps up to 18 fractional digits) to avoid
+ *   overflow in the integer accumulator. Which is sufficient for double precision and
+ *   more than accurate enough for the precision of ECG data.
+ */
+static inline bool parse_double(const char *p, const char *end, double &out, const char *&next) {
+    p = skip_spaces(p, end);
+    if (p >= end) return false;
+
+    bool neg = false;
+    if (*p == '+' || *p == '-') {
+        neg = (*p == '-');
+        ++p;
+        if (p >= end) return false;
+    }
+
+    uint64_t int_part = 0;
+    bool saw_digit = false;
+    while (p < end) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c < '0' || c > '9') break;
+        saw_digit = true;
+
+        uint64_t d = static_cast<uint64_t>(c - '0');
+        if (int_part <= (UINT64_MAX - d) / 10) int_part = int_part * 10 + d;
+        ++p;
+    }
+
+    uint64_t frac_part = 0;
+    int frac_digits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        while (p < end) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c < '0' || c > '9') break;
+            saw_digit = true;
+
+            if (frac_digits < 18) {
+                frac_part = frac_part * 10 + static_cast<uint64_t>(c - '0');
+                ++frac_digits;
+            }
+            ++p;
+        }
+    }
+
+    if (!saw_digit) return false;
+
+    int exp10 = 0;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *pe = p + 1;
+        if (pe < end) {
+            bool exp_neg = false;
+            if (*pe == '+' || *pe == '-') {
+                exp_neg = (*pe == '-');
+                ++pe;
+            }
+
+            int e = 0;
+            bool saw_e = false;
+            while (pe < end) {
+                unsigned char c = static_cast<unsigned char>(*pe);
+                if (c < '0' || c > '9') break;
+                saw_e = true;
+                if (e < 10000) e = e * 10 + static_cast<int>(c - '0');
+                ++pe;
+            }
+
+            if (saw_e) {
+                exp10 = exp_neg ? -e : e;
+                p = pe;
+            }
+        }
+    }
+
+    double val = static_cast<double>(int_part);
+    if (frac_digits > 0) val += static_cast<double>(frac_part) * pow10_i(-frac_digits);
+    if (exp10 != 0) val *= pow10_i(exp10);
+
+    out = neg ? -val : val;
+    next = p;
+    return true;
+}
+
+/**
+ * @brief Fast-path float parse for regular fixed-format data columns.
+ *
+ * Handles the common `[-]digits[.digits]` shape with the SWAR digit kernel
+ * and no exponent. Returns false on anything irregular (exponent, stray
+ * characters, missing digits); the caller then re-parses the line with the
+ * permissive parse_double so messy rows and headers behave exactly as before.
+ */
+static inline bool parse_double_fast(const char *p, const char *end, double &out,
+                                     const char *&next) {
+    while (p < end && (*p == ' ' || *p == '\t')) ++p;
+    if (p >= end) return false;
+
+    bool neg = false;
+    if (*p == '+' || *p == '-') {
+        neg = (*p == '-');
+        ++p;
+        if (p >= end) return false;
+    }
+
+    uint64_t int_part = 0;
+    int int_digits = 0;
+    p = parse_digit_run(p, end, int_part, int_digits);
+
+    uint64_t frac_part = 0;
+    int frac_digits = 0;
+    if (p < end && *p == '.') {
+        ++p;
+        p = parse_digit_run(p, end, frac_part, frac_digits);
+        if (frac_digits > 18) return false; // parse_double caps; keep results identical
+    }
+
+    if (int_digits == 0 && frac_digits == 0) return false;
+
+    // Irregular continuation (exponent, units, garbage) -> permissive parser.
+    if (p < end && !is_space(static_cast<unsigned char>(*p))) return false;
+
+    double val = static_cast<double>(int_part);
+    if (frac_digits > 0) val += static_cast<double>(frac_part) * pow10_i(-frac_digits);
+
+    out = neg ? -val : val;
+    next = p;
+    return true;
+}
+
+/**
+ * @brief Compute the median of a vector in-place.
+ *
+ * Uses std::nth_element and may reorder elements.
+ * Returns 0.0 for an empty vector.
+ */
+static double median_in_place(std::vector<double> &v) {
+    std::size_t n = v.size();
+    if (n == 0) return 0.0;
+
+    std::size_t mid = n / 2;
+    std::nth_element(v.begin(), v.begin() + static_cast<long>(mid), v.end());
+    double m = v[mid];
+    if (n % 2 == 1) return m;
+
+    auto max_it = std::max_element(v.begin(), v.begin() + static_cast<long>(mid));
+    return 0.5 * (m + *max_it);
+}
+
+
+/**
+ * @brief Read the remainder of the current line as trimmed text.
+ *
+ * Skips leading whitespace, stops at newline, and trims trailing whitespace.
+ * Returns nullopt if the line is empty after trimming.
+ */
+static inline std::optional<std::string> read_trimmed_eol_text(const char *&p, const char *end) {
+    p = skip_spaces(p, end);
+    const char *s = p;
+    while (p < end && *p != '\n' && *p != '\r') ++p;
+
+    const char *e = p;
+    while (e > s && is_space(static_cast<unsigned char>(e[-1]))) --e;
+
+    if (e <= s) return std::nullopt;
+    return std::string(s, e);
+}
+
+/**
+ * @brief Parse a contiguous byte range that starts and ends on line boundaries.
+ *
+ * This is the per-line workhorse shared by the single-threaded,
+ * multi-threaded and streaming parse paths. Header fields populate @p meta
+ * (header lines only appear near the top of real exports, so chunks past the
+ * first rarely see any); numeric rows append to @p t and @p v.
+ *
+ * Stops after @p max_rows numeric rows and returns where parsing ended
+ * (always a line boundary), so callers can resume from the returned pointer.
+ *
+ * With @p time_column false (implicit uniform time), only the value column is
+ * converted: the time token is parsed just for the chunk's first row (pushed
+ * as the single element of @p t, so callers can recover t0) and skipped
+ * afterwards.
+ */
+static const char *parse_ecg_chunk(const char *p, const char *end,
+                                   std::vector<double> &t, std::vector<double> &v,
+                                   EcgMeta &meta,
+                                   std::size_t max_rows = std::numeric_limits<std::size_t>::max(),
+                                   bool time_column = true) {
+    std::size_t rows = 0;
+    while (p < end && rows < max_rows) {
+        p = skip_spaces(p, end);
+        if (p >= end) break;
+
+        if (starts_with(p, end, "Interval=")) {
+            p += 9;
+            double interval = 0.0;
+            const char *next = nullptr;
+            if (parse_double(p, end, interval, next)) meta.interval_s = interval;
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        if (starts_with(p, end, "ChannelTitle=")) {
+            p += 13;
+            if (auto s = read_trimmed_eol_text(p, end)) meta.channel_title = std::move(*s);
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        if (starts_with(p, end, "Range=")) {
+            p += 6;
+            if (auto s = read_trimmed_eol_text(p, end)) meta.range = std::move(*s);
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        // Fast-skip any header-ish line that contains '=' before whitespace.
+        {
+            const char *q = p;
+            while (q < end && !is_space(static_cast<unsigned char>(*q)) && *q != '\n' && *q != '\r') {
+                if (*q == '=') {
+                    p = skip_to_eol(p, end);
+                    goto continue_outer;
+                }
+                ++q;
+            }
+        }
+
+        // Value-only rows: convert the time token once (first row, for t0),
+        // then merely scan past it. The value parse still validates the line,
+        // so garbage rows are skipped just like in two-column mode.
+        if (!time_column) {
+            double t_val = 0.0;
+            double v_val = 0.0;
+            const char *p0_end = nullptr;
+            const char *p1_end = nullptr;
+
+            if (t.empty()) {
+                if (!parse_double(p, end, t_val, p0_end)) {
+                    p = skip_to_eol(p, end);
+                    continue;
+                }
+            } else {
+                const char c = *p;
+                if (c != '+' && c != '-' && c != '.' && (c < '0' || c > '9')) {
+                    p = skip_to_eol(p, end);
+                    continue;
+                }
+                p0_end = p;
+                while (p0_end < end && !is_space(static_cast<unsigned char>(*p0_end)))
+                    ++p0_end;
+            }
+
+            if (parse_double_fast(p0_end, end, v_val, p1_end) ||
+                parse_double(p0_end, end, v_val, p1_end)) {
+                if (t.empty()) t.push_back(t_val);
+                v.push_back(v_val);
+                ++rows;
+                p = skip_to_eol(p1_end, end);
+            } else {
+                p = skip_to_eol(p, end);
+            }
+            continue;
+        }
+
+        // Numeric row: two floats. Regular fixed-format rows take the SIMD/SWAR
+        // fast path; any irregular line is re-parsed with the permissive parser.
+        {
+            double t_val = 0.0;
+            double v_val = 0.0;
+            const char *p0_end = nullptr;
+            const char *p1_end = nullptr;
+
+            if (parse_double_fast(p, end, t_val, p0_end) &&
+                parse_double_fast(p0_end, end, v_val, p1_end)) {
+                t.push_back(t_val);
+                v.push_back(v_val);
+                ++rows;
+                p = skip_to_eol(p1_end, end);
+                goto continue_outer;
+            }
+
+            if (!parse_double(p, end, t_val, p0_end)) {
+                p = skip_to_eol(p, end);
+                goto continue_outer;
+            }
+
+            if (!parse_double(p0_end, end, v_val, p1_end)) {
+                p = skip_to_eol(p, end);
+                goto continue_outer;
+            }
+
+            t.push_back(t_val);
+            v.push_back(v_val);
+            ++rows;
+            p = skip_to_eol(p1_end, end);
+        }
+
+    continue_outer:
+        continue;
+    }
+    return p;
+}
+
+/**
+ * @brief Derive fs from meta/time data after the rows are assembled.
+ *
+ * - If Interval= is present and > 0, fs = 1 / interval.
+ * - Else, if at least 2 timestamps exist, compute dt series and use fs = 1 / median(dt).
+ */
+static std::optional<double> infer_fs_from(const EcgMeta &meta, const std::vector<double> &t) {
+    if (meta.interval_s && *meta.interval_s > 0.0) return 1.0 / *meta.interval_s;
+
+    if (t.size() > 1) {
+        std::vector<double> dt;
+        dt.reserve(t.size() - 1);
+        for (std::size_t i = 1; i < t.size(); ++i) dt.push_back(t[i] - t[i - 1]);
+
+        double med_dt = median_in_place(dt);
+        if (med_dt > 0.0 && std::isfinite(med_dt)) return 1.0 / med_dt;
+    }
+    return std::nullopt;
+}
+
+static void infer_fs(EcgData &result) {
+    result.fs = infer_fs_from(result.meta, result.t);
+}
+
+/**
+ * @brief Parse ECG content already loaded into memory.
+ *
+ * Reads line-by-line from a raw buffer. Header fields populate EcgMeta.
+ * Numeric rows append to t and v.
+ *
+ * When @p threads > 1 (or 0 for hardware concurrency), the buffer is split on
+ * newline boundaries into per-thread chunks which are parsed into thread-local
+ * vectors and stitched back together in order. Header keys are recognized in
+ * any chunk; the first chunk that sees a key wins, which matches the
+ * single-threaded behavior for real exports where headers sit at the top.
+ *
+ * With @p time_column false, only the value column is converted; result.t
+ * stays empty and result.t0 carries the first row's timestamp.
+ *
+ * Throws std::runtime_error if no numeric rows are found.
+ */
+static EcgData parse_ecg_bytes(const char *buf, std::size_t len, int threads = 1,
+                               bool time_column = true) {
+    EcgData result;
+
+    const char *end = buf + len;
+
+    unsigned n_workers = threads <= 0 ? std::thread::hardware_concurrency()
+                                      : static_cast<unsigned>(threads);
+    if (n_workers == 0) n_workers = 1;
+
+    // Small inputs are not worth the thread spin-up and stitch cost.
+    constexpr std::size_t kMinBytesPerChunk = 4u << 20;
+    if (len / kMinBytesPerChunk < n_workers)
+        n_workers = static_cast<unsigned>(std::max<std::size_t>(1, len / kMinBytesPerChunk));
+
+    if (n_workers <= 1) {
+        std::size_t est_rows = len / 32;
+        if (est_rows < 256'000) est_rows = 256'000;
+        if (est_rows > 50'000'000) est_rows = 50'000'000;
+        result.t.reserve(est_rows);
+        result.v.reserve(est_rows);
+
+        parse_ecg_chunk(buf, end, result.t, result.v, result.meta,
+                        std::numeric_limits<std::size_t>::max(), time_column);
+    } else {
+        // Chunk boundaries: advance each nominal split point to the next newline
+        // so every worker sees whole lines only.
+        std::vector<const char *> bounds;
+        bounds.reserve(n_workers + 1);
+        bounds.push_back(buf);
+        for (unsigned i = 1; i < n_workers; ++i) {
+            const char *p = buf + (len / n_workers) * i;
+            if (p <= bounds.back()) continue;
+            p = skip_to_eol(p, end);
+            if (p >= end) break;
+            bounds.push_back(p);
+        }
+        bounds.push_back(end);
+
+        const std::size_t n_chunks = bounds.size() - 1;
+        std::vector<std::vector<double>> ts(n_chunks), vs(n_chunks);
+        std::vector<EcgMeta> metas(n_chunks);
+
+        std::vector<std::thread> workers;
+        workers.reserve(n_chunks);
+        for (std::size_t c = 0; c < n_chunks; ++c) {
+            workers.emplace_back([&, c]() {
+                const std::size_t chunk_len =
+                    static_cast<std::size_t>(bounds[c + 1] - bounds[c]);
+                std::size_t est_rows = chunk_len / 32 + 16;
+                ts[c].reserve(est_rows);
+                vs[c].reserve(est_rows);
+                parse_ecg_chunk(bounds[c], bounds[c + 1], ts[c], vs[c], metas[c],
+                                std::numeric_limits<std::size_t>::max(), time_column);
+            });
+        }
+        for (auto &w : workers) w.join();
+
+        std::size_t total = 0;
+        for (const auto &tc : ts) total += tc.size();
+        result.t.reserve(total);
+        result.v.reserve(total);
+
+        for (std::size_t c = 0; c < n_chunks; ++c) {
+            result.t.insert(result.t.end(), ts[c].begin(), ts[c].end());
+            result.v.insert(result.v.end(), vs[c].begin(), vs[c].end());
+
+            if (!result.meta.interval_s) result.meta.interval_s = metas[c].interval_s;
+            if (!result.meta.channel_title) result.meta.channel_title = std::move(metas[c].channel_title);
+            if (!result.meta.range) result.meta.range = std::move(metas[c].range);
+        }
+    }
+
+    if (result.v.empty()) throw std::runtime_error("No numeric data rows were found.");
+
+    if (!time_column) {
+        // Value-only mode: each chunk contributed at most one timestamp (its
+        // first row); the overall t0 is the earliest one.
+        if (!result.t.empty()) result.t0 = result.t.front();
+        result.t.clear();
+        result.t.shrink_to_fit();
+    }
+
+    infer_fs(result);
+
+    return result;
+}
+
+
+// ---------------------------------------------------------------------------
+// Multi-channel parse
+//
+// Newer exports carry 3-8 value columns per row. These routines parse every
+// value column into its own contiguous array, reusing the same header
+// handling, fast/permissive float parsers and newline-aligned chunking as the
+// two-column path, so an 8-channel file parses in roughly one pass rather
+// than eight re-exports.
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Count the value columns on the first numeric row.
+ *
+ * Skips header-ish lines ('=' before whitespace) the same way the row parser
+ * does, then counts floats on the first line whose leading token parses.
+ * Returns columns minus one (the time column).
+ *
+ * Throws std::runtime_error if no numeric row is found.
+ */
+static std::size_t detect_channel_count(const char *p, const char *end) {
+    while (p < end) {
+        p = skip_spaces(p, end);
+        if (p >= end) break;
+
+        bool header = false;
+        for (const char *q = p;
+             q < end && !is_space(static_cast<unsigned char>(*q)); ++q) {
+            if (*q == '=') {
+                header = true;
+                break;
+            }
+        }
+        if (header) {
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        const char *eol = find_eol(p, end);
+        std::size_t n = 0;
+        const char *q = p;
+        double x = 0.0;
+        const char *nx = nullptr;
+        while (q < eol && parse_double(q, eol, x, nx)) {
+            ++n;
+            q = nx;
+        }
+        if (n >= 2) return n - 1;
+
+        p = skip_to_eol(p, end);
+    }
+    throw std::runtime_error("Could not detect channel count: no numeric data rows were found.");
+}
+
+/**
+ * @brief Split a ChannelTitle= line into per-channel titles.
+ *
+ * LabChart writes one tab-separated title per channel; single-channel exports
+ * have no tabs and yield one entry. Entries are whitespace-trimmed.
+ */
+static std::vector<std::string> split_channel_titles(const std::string &line) {
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    while (start <= line.size()) {
+        std::size_t tab = line.find('\t', start);
+        if (tab == std::string::npos) tab = line.size();
+
+        std::size_t s = start, e = tab;
+        while (s < e && is_space(static_cast<unsigned char>(line[s]))) ++s;
+        while (e > s && is_space(static_cast<unsigned char>(line[e - 1]))) --e;
+        if (e > s) out.emplace_back(line.substr(s, e - s));
+
+        if (tab == line.size()) break;
+        start = tab + 1;
+    }
+    return out;
+}
+
+/**
+ * @brief Multi-channel variant of parse_ecg_chunk.
+ *
+ * Header handling is identical; numeric rows must yield the time value plus
+ * @p n_channels floats or the whole line is skipped (mirroring the
+ * skip-garbage-lines behavior of the two-column parser). Values land in
+ * @p chans, which must already hold n_channels vectors.
+ */
+static const char *parse_ecg_chunk_multi(const char *p, const char *end,
+                                         std::vector<double> &t,
+                                         std::vector<std::vector<double>> &chans,
+                                         EcgMeta &meta,
+                                         std::size_t n_channels) {
+    std::vector<double> row(n_channels);
+
+    while (p < end) {
+        p = skip_spaces(p, end);
+        if (p >= end) break;
+
+        if (starts_with(p, end, "Interval=")) {
+            p += 9;
+            double interval = 0.0;
+            const char *next = nullptr;
+            if (parse_double(p, end, interval, next)) meta.interval_s = interval;
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        if (starts_with(p, end, "ChannelTitle=")) {
+            p += 13;
+            if (auto s = read_trimmed_eol_text(p, end)) meta.channel_title = std::move(*s);
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        if (starts_with(p, end, "Range=")) {
+            p += 6;
+            if (auto s = read_trimmed_eol_text(p, end)) meta.range = std::move(*s);
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        {
+            const char *q = p;
+            bool header = false;
+            while (q < end && !is_space(static_cast<unsigned char>(*q)) && *q != '\n' && *q != '\r') {
+                if (*q == '=') {
+                    header = true;
+                    break;
+                }
+                ++q;
+            }
+            if (header) {
+                p = skip_to_eol(p, end);
+                continue;
+            }
+        }
+
+        // Token parsing is clamped to the current line so a short row is
+        // skipped instead of silently consuming values from the next one
+        // (the permissive parser would otherwise skip across the newline).
+        const char *eol = find_eol(p, end);
+
+        double t_val = 0.0;
+        const char *q = nullptr;
+        if (!(parse_double_fast(p, eol, t_val, q) || parse_double(p, eol, t_val, q))) {
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        bool ok = true;
+        for (std::size_t c = 0; c < n_channels; ++c) {
+            double v_val = 0.0;
+            const char *q2 = nullptr;
+            if (!(parse_double_fast(q, eol, v_val, q2) || parse_double(q, eol, v_val, q2))) {
+                ok = false;
+                break;
+            }
+            row[c] = v_val;
+            q = q2;
+        }
+        if (!ok) {
+            p = skip_to_eol(p, end);
+            continue;
+        }
+
+        t.push_back(t_val);
+        for (std::size_t c = 0; c < n_channels; ++c) chans[c].push_back(row[c]);
+        p = skip_to_eol(q, end);
+    }
+    return p;
+}
+
+/**
+ * @brief Parse multi-channel ECG content already loaded into memory.
+ *
+ * @param n_channels Value columns per row; 0 (default) detects the count from
+ *        the first numeric row. Rows with fewer columns are skipped.
+ * @param threads As in parse_ecg_bytes: newline-aligned chunks parsed in
+ *        parallel and stitched back in order, which scales with row count
+ *        regardless of how many columns each row carries.
+ *
+ * Throws std::runtime_error if no numeric rows are found.
+ */
+static EcgMultiData parse_ecg_bytes_multi(const char *buf, std::size_t len,
+                                          int threads = 1, std::size_t n_channels = 0) {
+    EcgMultiData result;
+
+    const char *end = buf + len;
+
+    if (n_channels == 0) n_channels = detect_channel_count(buf, end);
+    result.channels.resize(n_channels);
+
+    unsigned n_workers = threads <= 0 ? std::thread::hardware_concurrency()
+                                      : static_cast<unsigned>(threads);
+    if (n_workers == 0) n_workers = 1;
+
+    constexpr std::size_t kMinBytesPerChunk = 4u << 20;
+    if (len / kMinBytesPerChunk < n_workers)
+        n_workers = static_cast<unsigned>(std::max<std::size_t>(1, len / kMinBytesPerChunk));
+
+    if (n_workers <= 1) {
+        parse_ecg_chunk_multi(buf, end, result.t, result.channels, result.meta, n_channels);
+    } else {
+        std::vector<const char *> bounds;
+        bounds.reserve(n_workers + 1);
+        bounds.push_back(buf);
+        for (unsigned i = 1; i < n_workers; ++i) {
+            const char *p = buf + (len / n_workers) * i;
+            if (p <= bounds.back()) continue;
+            p = skip_to_eol(p, end);
+            if (p >= end) break;
+            bounds.push_back(p);
+        }
+        bounds.push_back(end);
+
+        const std::size_t n_chunks = bounds.size() - 1;
+        std::vector<std::vector<double>> ts(n_chunks);
+        std::vector<std::vector<std::vector<double>>> css(n_chunks);
+        std::vector<EcgMeta> metas(n_chunks);
+
+        std::vector<std::thread> workers;
+        workers.reserve(n_chunks);
+        for (std::size_t c = 0; c < n_chunks; ++c) {
+            workers.emplace_back([&, c]() {
+                css[c].resize(n_channels);
+                parse_ecg_chunk_multi(bounds[c], bounds[c + 1], ts[c], css[c],
+                                      metas[c], n_channels);
+            });
+        }
+        for (auto &w : workers) w.join();
+
+        std::size_t total = 0;
+        for (const auto &tc : ts) total += tc.size();
+        result.t.reserve(total);
+        for (auto &ch : result.channels) ch.reserve(total);
+
+        for (std::size_t c = 0; c < n_chunks; ++c) {
+            result.t.insert(result.t.end(), ts[c].begin(), ts[c].end());
+            for (std::size_t ch = 0; ch < n_channels; ++ch)
+                result.channels[ch].insert(result.channels[ch].end(),
+                                           css[c][ch].begin(), css[c][ch].end());
+
+            if (!result.meta.interval_s) result.meta.interval_s = metas[c].interval_s;
+            if (!result.meta.channel_title) result.meta.channel_title = std::move(metas[c].channel_title);
+            if (!result.meta.range) result.meta.range = std::move(metas[c].range);
+        }
+    }
+
+    if (result.t.empty()) throw std::runtime_error("No numeric data rows were found.");
+
+    if (result.meta.channel_title)
+        result.channel_titles = split_channel_titles(*result.meta.channel_title);
+
+    result.fs = infer_fs_from(result.meta, result.t);
+
+    return result;
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+/**
+ * @brief Pipelined page-in for a freshly mapped file.
+ *
+ * A cold mmap parse faults pages on demand at 4 KB granularity, which on
+ * high-latency filesystems (NFS archives) leaves the parser stalled far below
+ * sequential bandwidth. This helper advises MADV_SEQUENTIAL on the whole
+ * mapping (bigger kernel readahead window, eager drop-behind) and runs a
+ * worker thread that walks ahead of the parser one stride at a time: it
+ * queues async readahead with MADV_WILLNEED, then touches one byte per page.
+ * The touches block at disk speed, so the worker naturally paces itself a
+ * stride or so ahead of the parser instead of flooding the page cache, and
+ * the parser mostly lands on resident pages.
+ *
+ * The destructor stops and joins the worker, so an instance must not outlive
+ * the mapping it was given.
+ */
+class MapReadahead {
+public:
+    MapReadahead(const void *map, std::size_t len) : stop_(false) {
+        ::madvise(const_cast<void *>(map), len, MADV_SEQUENTIAL);
+        worker_ = std::thread([this, map, len]() { run(map, len); });
+    }
+
+    ~MapReadahead() {
+        stop_.store(true, std::memory_order_relaxed);
+        if (worker_.joinable()) worker_.join();
+    }
+
+    MapReadahead(const MapReadahead &) = delete;
+    MapReadahead &operator=(const MapReadahead &) = delete;
+
+private:
+    static constexpr std::size_t kStrideBytes = std::size_t(16) << 20;
+    static constexpr std::size_t kPageBytes = 4096;
+
+    void run(const void *map, std::size_t len) {
+        const char *base = static_cast<const char *>(map);
+        volatile char sink = 0;
+        for (std::size_t off = 0; off < len; off += kStrideBytes) {
+            const std::size_t n = std::min(kStrideBytes, len - off);
+            ::madvise(const_cast<char *>(base) + off, n, MADV_WILLNEED);
+            for (std::size_t p = 0; p < n; p += kPageBytes) {
+                if (stop_.load(std::memory_order_relaxed)) return;
+                sink = base[off + p];
+            }
+        }
+        (void)sink;
+    }
+
+    std::atomic<bool> stop_;
+    std::thread worker_;
+};
+#endif
+
+/// True when ECG_PARSE_NO_MMAP is set (to anything but "0"): skip mmap and
+/// read the file with plain sequential reads instead, for filesystems where
+/// mmap readahead performs poorly.
+static inline bool parse_prefers_buffered_io() {
+    const char *v = std::getenv("ECG_PARSE_NO_MMAP");
+    return v && *v && !(v[0] == '0' && v[1] == '\0');
+}
+
+// ---------------------------------------------------------------------------
+// Compressed input
+//
+// Archives are stored gzipped (text compresses roughly 8:1), so the parser
+// recognizes compression magic bytes and, with zlib available, decodes and
+// parses in a two-stage pipeline instead of requiring a decompress-to-temp
+// step. zstd magic is recognized only to produce a useful error.
+// ---------------------------------------------------------------------------
+
+static inline bool looks_gzip(const unsigned char *p, std::size_t n) {
+    return n >= 2 && p[0] == 0x1f && p[1] == 0x8b;
+}
+
+static inline bool looks_zstd(const unsigned char *p, std::size_t n) {
+    return n >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd;
+}
+
+#if defined(ECG_HAVE_ZLIB)
+/**
+ * @brief Pipelined parse of a gzip-compressed ECG file.
+ *
+ * A producer thread inflates the file into ~4 MB blocks feeding a small
+ * bounded queue while the calling thread parses them, so decode and parse
+ * overlap instead of serializing through a temporary file. Blocks are cut to
+ * whole lines before parsing: the partial trailing line of each block is
+ * carried into the next one.
+ *
+ * Inflation is inherently serial, so unlike parse_ecg_bytes there is no
+ * multi-threaded parse fan-out; with the SWAR row parser the decode stage is
+ * the bottleneck anyway.
+ *
+ * Value-only mode (@p time_column false) behaves as in parse_ecg_bytes:
+ * result.t stays empty and result.t0 carries the first row's timestamp.
+ */
+static EcgData parse_ecg_gzip_cpp(const std::string &path, bool time_column = true) {
+    const auto t_parse0 = std::chrono::steady_clock::now();
+
+    gzFile gz = gzopen(path.c_str(), "rb");
+    if (!gz) throw std::runtime_error("Could not open gzip ECG file: " + path);
+    gzbuffer(gz, 1u << 20);
+
+    constexpr std::size_t kBlockBytes = std::size_t(4) << 20;
+    constexpr std::size_t kMaxQueuedBlocks = 4;
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::vector<std::string> blocks;
+    bool done = false;
+    std::string error;
+
+    std::thread producer([&]() {
+        try {
+            for (;;) {
+                std::string block(kBlockBytes, '\0');
+                const int n = gzread(gz, &block[0], static_cast<unsigned>(block.size()));
+                if (n < 0) {
+                    int errnum = 0;
+                    const char *msg = gzerror(gz, &errnum);
+                    throw std::runtime_error("gzip read error in " + path + ": " +
+                                             (msg ? msg : "unknown"));
+                }
+                if (n == 0) break;
+                block.resize(static_cast<std::size_t>(n));
+
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [&]() { return blocks.size() < kMaxQueuedBlocks; });
+                blocks.push_back(std::move(block));
+                cv.notify_all();
+            }
+        } catch (const std::exception &e) {
+            std::lock_guard<std::mutex> lock(m);
+            error = e.what();
+        }
+        {
+            std::lock_guard<std::mutex> lock(m);
+            done = true;
+        }
+        cv.notify_all();
+    });
+
+    EcgData result;
+    result.t.reserve(256'000);
+    result.v.reserve(256'000);
+
+    std::string carry;
+    std::size_t decoded_bytes = 0;
+
+    for (;;) {
+        std::string block;
+        {
+            std::unique_lock<std::mutex> lock(m);
+            cv.wait(lock, [&]() { return !blocks.empty() || done; });
+            if (blocks.empty()) break;
+            block = std::move(blocks.front());
+            blocks.erase(blocks.begin());
+            cv.notify_all();
+        }
+        decoded_bytes += block.size();
+
+        if (!carry.empty()) {
+            carry += block;
+            block.swap(carry);
+            carry.clear();
+        }
+
+        const std::size_t last_nl = block.rfind('\n');
+        if (last_nl == std::string::npos) {
+            carry = std::move(block);
+            continue;
+        }
+
+        parse_ecg_chunk(block.data(), block.data() + last_nl + 1,
+                        result.t, result.v, result.meta,
+                        std::numeric_limits<std::size_t>::max(), time_column);
+        carry.assign(block, last_nl + 1, std::string::npos);
+    }
+
+    producer.join();
+    gzclose(gz);
+
+    if (!error.empty()) throw std::runtime_error(error);
+
+    if (!carry.empty()) {
+        carry += '\n';
+        parse_ecg_chunk(carry.data(), carry.data() + carry.size(),
+                        result.t, result.v, result.meta,
+                        std::numeric_limits<std::size_t>::max(), time_column);
+    }
+
+    if (result.v.empty()) throw std::runtime_error("No numeric data rows were found.");
+
+    if (!time_column) {
+        if (!result.t.empty()) result.t0 = result.t.front();
+        result.t.clear();
+        result.t.shrink_to_fit();
+    }
+
+    infer_fs(result);
+
+    ParsePerf::instance().record("parse.parse_ms", ms_since(t_parse0));
+    ParsePerf::instance().record("parse.rows", static_cast<double>(result.v.size()));
+    ParsePerf::instance().record("parse.bytes", static_cast<double>(decoded_bytes));
+
+    return result;
+}
+#endif // ECG_HAVE_ZLIB
+
+/// Route @p path to the gzip pipeline when its magic bytes say so; throws a
+/// descriptive error for gzip-without-zlib builds and for zstd input.
+/// Returns std::nullopt for plain text, which callers parse as before.
+static inline std::optional<EcgData> try_parse_compressed(const std::string &path,
+                                                          bool time_column) {
+    unsigned char magic[4] = {0, 0, 0, 0};
+    std::size_t got = 0;
+    {
+        std::ifstream mf(path, std::ios::binary);
+        if (mf.is_open()) {
+            mf.read(reinterpret_cast<char *>(magic), sizeof(magic));
+            got = static_cast<std::size_t>(mf.gcount());
+        }
+    }
+
+    if (looks_gzip(magic, got)) {
+#if defined(ECG_HAVE_ZLIB)
+        return parse_ecg_gzip_cpp(path, time_column);
+#else
+        throw std::runtime_error(
+            "gzip-compressed ECG file, but the parser was built without zlib "
+            "(ECG_HAVE_ZLIB); decompress first: " + path);
+#endif
+    }
+
+    if (looks_zstd(magic, got))
+        throw std::runtime_error(
+            "zstd-compressed ECG input is not supported; decompress first or "
+            "re-archive as gzip: " + path);
+
+    return std::nullopt;
+}
+
+/**
+ * @brief Parse an ECG file from disk (native C++).
+ *
+ * Uses memory-mapped IO on Unix/macOS and Windows to avoid an extra copy and
+ * reduce peak memory usage, with MADV_SEQUENTIAL plus a pipelined readahead
+ * thread (MapReadahead) keeping page-in I/O ahead of the parser on cold
+ * caches. Falls back to reading the file into a std::string buffer on other
+ * platforms, or anywhere when ECG_PARSE_NO_MMAP is set. Gzip input is
+ * detected by magic bytes and decoded through the pipelined gzip path.
+ *
+ * Throws std::runtime_error on IO errors, empty files, or parse failures.
+ *
+ * @param threads Worker threads for the parse: 1 (default) keeps the
+ *        single-threaded path, 0 uses hardware concurrency.
+ * @param time_column Convert the time column (default). When false, only the
+ *        value column is parsed and result.t0 carries the first timestamp.
+ */
+static EcgData parse_ecg_file_cpp(const std::string &path, int threads = 1,
+                                  bool time_column = true) {
+    if (auto compressed = try_parse_compressed(path, time_column))
+        return std::move(*compressed);
+
+    const auto t_io0 = std::chrono::steady_clock::now();
+#if defined(__unix__) || defined(__APPLE__)
+    if (!parse_prefers_buffered_io()) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open ECG file: " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat ECG file: " + path);
+        }
+
+        if (st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("ECG file is empty: " + path);
+        }
+
+        std::size_t len = static_cast<std::size_t>(st.st_size);
+        void *map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) throw std::runtime_error("mmap failed for ECG file: " + path);
+
+        ParsePerf::instance().record("parse.io_ms", ms_since(t_io0));
+
+        try {
+            const auto t_parse0 = std::chrono::steady_clock::now();
+            EcgData data;
+            {
+                MapReadahead readahead(map, len);
+                data = parse_ecg_bytes(static_cast<const char *>(map), len, threads, time_column);
+            }
+            ParsePerf::instance().record("parse.parse_ms", ms_since(t_parse0));
+            ParsePerf::instance().record("parse.rows", static_cast<double>(data.v.size()));
+            ParsePerf::instance().record("parse.bytes", static_cast<double>(len));
+            ::munmap(map, len);
+            return data;
+        } catch (...) {
+            ::munmap(map, len);
+            throw;
+        }
+    }
+#endif
+    // Fallback (and ECG_PARSE_NO_MMAP): read the file into memory with plain
+    // sequential reads, then parse.
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        throw std::runtime_error("Could not open ECG file: " + path);
+    }
+
+    f.seekg(0, std::ios::end);
+    std::streampos endp = f.tellg();
+    if (endp <= 0) {
+        throw std::runtime_error("ECG file is empty: " + path);
+    }
+    f.seekg(0, std::ios::beg);
+
+    std::string buf;
+    buf.resize(static_cast<std::size_t>(endp));
+    f.read(&buf[0], static_cast<std::streamsize>(buf.size()));
+
+    ParsePerf::instance().record("parse.io_ms", ms_since(t_io0));
+
+    const auto t_parse0 = std::chrono::steady_clock::now();
+    EcgData data = parse_ecg_bytes(buf.data(), buf.size(), threads, time_column);
+    ParsePerf::instance().record("parse.parse_ms", ms_since(t_parse0));
+    ParsePerf::instance().record("parse.rows", static_cast<double>(data.v.size()));
+    ParsePerf::instance().record("parse.bytes", static_cast<double>(buf.size()));
+    return data;
+}
+
+/**
+ * @brief Parse a multi-channel ECG file from disk (native C++).
+ *
+ * Same IO strategy as parse_ecg_file_cpp (mmap + pipelined readahead on
+ * Unix/macOS, buffered read elsewhere or under ECG_PARSE_NO_MMAP); the parse
+ * itself goes through parse_ecg_bytes_multi.
+ *
+ * @param threads Worker threads for the parse (1 default, 0 = hardware concurrency).
+ * @param n_channels Value columns per row; 0 detects from the first numeric row.
+ */
+static EcgMultiData parse_ecg_file_multi_cpp(const std::string &path, int threads = 1,
+                                             std::size_t n_channels = 0) {
+    const auto t_io0 = std::chrono::steady_clock::now();
+#if defined(__unix__) || defined(__APPLE__)
+    if (!parse_prefers_buffered_io()) {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Could not open ECG file: " + path);
+
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not stat ECG file: " + path);
+        }
+
+        if (st.st_size <= 0) {
+            ::close(fd);
+            throw std::runtime_error("ECG file is empty: " + path);
+        }
+
+        std::size_t len = static_cast<std::size_t>(st.st_size);
+        void *map = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) throw std::runtime_error("mmap failed for ECG file: " + path);
+
+        ParsePerf::instance().record("parse.io_ms", ms_since(t_io0));
+
+        try {
+            const auto t_parse0 = std::chrono::steady_clock::now();
+            EcgMultiData data;
+            {
+                MapReadahead readahead(map, len);
+                data = parse_ecg_bytes_multi(static_cast<const char *>(map), len,
+                                             threads, n_channels);
+            }
+            ParsePerf::instance().record("parse.parse_ms", ms_since(t_parse0));
+            ParsePerf::instance().record("parse.rows", static_cast<double>(data.t.size()));
+            ParsePerf::instance().record("parse.bytes", static_cast<double>(len));
+            ::munmap(map, len);
+            return data;
+        } catch (...) {
+            ::munmap(map, len);
+            throw;
+        }
+    }
+#endif
+    std::ifstream f(path, std::ios::binary);
+    if (!f.is_open()) {
+        throw std::runtime_error("Could not open ECG file: " + path);
+    }
+
+    f.seekg(0, std::ios::end);
+    std::streampos endp = f.tellg();
+    if (endp <= 0) {
+        throw std::runtime_error("ECG file is empty: " + path);
+    }
+    f.seekg(0, std::ios::beg);
+
+    std::string buf;
+    buf.resize(static_cast<std::size_t>(endp));
+    f.read(&buf[0], static_cast<std::streamsize>(buf.size()));
+
+    ParsePerf::instance().record("parse.io_ms", ms_since(t_io0));
+
+    const auto t_parse0 = std::chrono::steady_clock::now();
+    EcgMultiData data = parse_ecg_bytes_multi(buf.data(), buf.size(), threads, n_channels);
+    ParsePerf::instance().record("parse.parse_ms", ms_since(t_parse0));
+    ParsePerf::instance().record("parse.rows", static_cast<double>(data.t.size()));
+    ParsePerf::instance().record("parse.bytes", static_cast<double>(buf.size()));
+    return data;
+}
@@ -171,6 +171,71 @@ def test_raises_if_no_numeric_rows(tmp_path):
         parse_ecg_file_cpp(str(p))
 
 
+def test_fixed_format_rows_with_many_digits(tmp_path):
+    # Exercises the fast fixed-format kernel (8+ digit runs) and its
+    # fallback to the permissive parser on the exponent row.
+    p = write_tmp(
+        tmp_path,
+        "\n".join(
+            [
+                "Interval=0.00048828125",
+                "12345.67890123  -0.00012345",
+                "12345.67939  0.10000000",
+                "1.2e1  3.0",  # irregular: exponent goes through the slow path
+            ]
+        ),
+    )
+
+    t, v, fs, meta = parse_ecg_file_cpp(str(p))
+
+    np.testing.assert_allclose(t, [12345.67890123, 12345.67939, 12.0])
+    np.testing.assert_allclose(v, [-0.00012345, 0.1, 3.0])
+    assert fs == pytest.approx(2048.0)
+
+
+def test_threaded_parse_matches_single_threaded(tmp_path):
+    n = 5000
+    lines = ["Interval=0.004", "ChannelTitle=Lead II"]
+    lines += ["%.3f %.4f" % (i * 0.004, math.sin(i * 0.01)) for i in range(n)]
+    p = write_tmp(tmp_path, "\n".join(lines) + "\n")
+
+    t1, v1, fs1, meta1 = parse_ecg_file_cpp(str(p), threads=1)
+    tn, vn, fsn, metan = parse_ecg_file_cpp(str(p), threads=0)
+
+    np.testing.assert_array_equal(t1, tn)
+    np.testing.assert_array_equal(v1, vn)
+    assert fs1 == fsn
+    assert meta1 == metan
+
+
+def test_sidecar_cache_roundtrip_and_invalidation(tmp_path):
+    p = write_tmp(tmp_path, "Interval=0.01\nChannelTitle=Lead I\n0 1\n0.01 2\n0.02 3\n")
+
+    t1, v1, fs1, meta1 = parse_ecg_file_cpp(str(p))
+    sidecar = Path(str(p) + ".ecgbin")
+    assert sidecar.exists()
+
+    # Second open is served from the sidecar and must match exactly.
+    t2, v2, fs2, meta2 = parse_ecg_file_cpp(str(p))
+    np.testing.assert_array_equal(t1, t2)
+    np.testing.assert_array_equal(v1, v2)
+    assert fs1 == fs2
+    assert meta1 == meta2
+
+    # Changing the source invalidates the stale sidecar.
+    p.write_text("Interval=0.5\n0 7\n0.5 8\n", encoding="utf-8", newline="\n")
+    t3, v3, fs3, _ = parse_ecg_file_cpp(str(p))
+    np.testing.assert_allclose(t3, [0.0, 0.5])
+    np.testing.assert_allclose(v3, [7.0, 8.0])
+    assert fs3 == pytest.approx(2.0)
+
+
+def test_cache_false_writes_no_sidecar(tmp_path):
+    p = write_tmp(tmp_path, "0 1\n1 2\n")
+    parse_ecg_file_cpp(str(p), cache=False)
+    assert not Path(str(p) + ".ecgbin").exists()
+
+
 def test_arrays_survive_gc(tmp_path):
     p = write_tmp(tmp_path, "0 1\n1 2\n2 3\n")
     t, v, fs, meta = parse_ecg_file_cpp(str(p))
@@ -180,3 +245,176 @@ def test_arrays_survive_gc(tmp_path):
 
     assert float(t[0]) == 0.0
     assert float(v[-1]) == 3.0
+
+
+def test_stream_chunks_match_full_parse(tmp_path):
+    from ECGViewer.parseECG import parse_ecg_stream
+
+    n = 2500
+    lines = ["Interval=0.004", "ChannelTitle=Lead III"]
+    lines += ["%.3f %.4f" % (i * 0.004, math.sin(i * 0.02)) for i in range(n)]
+    p = write_tmp(tmp_path, "\n".join(lines) + "\n")
+
+    t_full, v_full, _, meta_full = parse_ecg_file_cpp(str(p), cache=False)
+
+    chunks = list(parse_ecg_stream(str(p), chunk_rows=1000))
+    assert len(chunks) == 3
+    assert [len(c[0]) for c in chunks] == [1000, 1000, 500]
+
+    t_cat = np.concatenate([c[0] for c in chunks])
+    v_cat = np.concatenate([c[1] for c in chunks])
+    np.testing.assert_array_equal(t_cat, t_full)
+    np.testing.assert_array_equal(v_cat, v_full)
+
+
+def test_stream_meta_after_first_chunk(tmp_path):
+    from ECGViewer.parseECG import parse_ecg_stream
+
+    p = write_tmp(tmp_path, "Interval=0.01\nChannelTitle=Lead I\n0 1\n0.01 2\n")
+
+    stream = parse_ecg_stream(str(p), chunk_rows=10)
+    next(stream)
+    assert stream.meta["interval_s"] == pytest.approx(0.01)
+    assert stream.meta["channel_title"] == "Lead I"
+
+    with pytest.raises(StopIteration):
+        next(stream)
+
+
+def test_perf_stats_accumulate(tmp_path):
+    from ECGViewer import parseECG
+
+    parseECG.reset_perf_stats()
+    p = write_tmp(tmp_path, "0 1\n1 2\n2 3\n")
+    parse_ecg_file_cpp(str(p), cache=False)
+
+    stats = parseECG.get_perf_stats()
+    assert stats["parse.rows"]["count"] == 1
+    assert stats["parse.rows"]["max"] == 3.0
+    assert stats["parse.parse_ms"]["p95"] >= stats["parse.parse_ms"]["p50"] >= 0.0
+
+    parseECG.reset_perf_stats()
+    assert parseECG.get_perf_stats() == {}
+
+
+def test_implicit_time_matches_full_parse(tmp_path):
+    n = 500
+    lines = ["Interval=0.004"]
+    lines += ["%.3f %.4f" % (1.5 + i * 0.004, math.sin(i * 0.05)) for i in range(n)]
+    p = write_tmp(tmp_path, "\n".join(lines) + "\n")
+
+    t_full, v_full, fs_full, meta_full = parse_ecg_file_cpp(str(p), cache=False)
+    t0, v, fs, meta = parse_ecg_file_cpp(str(p), cache=False, implicit_time=True)
+
+    assert isinstance(t0, float)
+    assert t0 == t_full[0]
+    np.testing.assert_array_equal(v, v_full)
+    assert fs == fs_full
+    assert meta == meta_full
+
+
+def test_implicit_time_requires_interval(tmp_path):
+    p = write_tmp(tmp_path, "0 1\n1 2\n")
+    with pytest.raises(RuntimeError, match="Interval"):
+        parse_ecg_file_cpp(str(p), cache=False, implicit_time=True)
+
+
+def test_multi_channel_parse(tmp_path):
+    lines = [
+        "Interval=0.004",
+        "ChannelTitle= Lead I\tLead II\tV1",
+    ]
+    for i in range(10):
+        t = i * 0.004
+        lines.append("%.3f %.4f %.4f %.4f" % (t, t + 1, t + 2, t + 3))
+    p = write_tmp(tmp_path, "\n".join(lines) + "\n")
+
+    from ECGViewer.parseECG import parse_ecg_file_multi
+
+    t, channels, fs, meta = parse_ecg_file_multi(str(p))
+
+    assert isinstance(channels, list) and len(channels) == 3
+    assert len(t) == 10
+    for c, ch in enumerate(channels):
+        np.testing.assert_allclose(ch, t + (c + 1))
+    assert fs == 250.0
+    assert meta["channel_titles"] == ["Lead I", "Lead II", "V1"]
+
+
+def test_multi_channel_skips_short_rows(tmp_path):
+    p = write_tmp(tmp_path, "0 1 2\n1 3\n2 4 5\n")
+
+    from ECGViewer.parseECG import parse_ecg_file_multi
+
+    t, channels, fs, meta = parse_ecg_file_multi(str(p), n_channels=2)
+
+    np.testing.assert_array_equal(t, [0.0, 2.0])
+    np.testing.assert_array_equal(channels[0], [1.0, 4.0])
+    np.testing.assert_array_equal(channels[1], [2.0, 5.0])
+    assert meta["channel_titles"] == []
+
+
+def test_parse_ecg_files_matches_single_parses(tmp_path):
+    paths = []
+    for k in range(5):
+        p = tmp_path / ("ecg_%d.txt" % k)
+        lines = ["Interval=0.004"]
+        lines += ["%.3f %.4f" % (i * 0.004, k + i * 0.1) for i in range(50)]
+        p.write_text("\n".join(lines) + "\n", encoding="utf-8", newline="\n")
+        paths.append(str(p))
+
+    from ECGViewer.parseECG import parse_ecg_files
+
+    results = parse_ecg_files(paths, max_workers=3)
+
+    assert len(results) == 5
+    for k, (t, v, fs, meta) in enumerate(results):
+        t1, v1, fs1, meta1 = parse_ecg_file_cpp(paths[k], cache=False)
+        np.testing.assert_array_equal(t, t1)
+        np.testing.assert_array_equal(v, v1)
+        assert fs == fs1
+        assert meta == meta1
+
+
+def test_parse_ecg_files_reports_failures(tmp_path):
+    good = write_tmp(tmp_path, "0 1\n1 2\n")
+    missing = tmp_path / "does_not_exist.txt"
+
+    from ECGViewer.parseECG import parse_ecg_files
+
+    with pytest.raises(RuntimeError, match="does_not_exist"):
+        parse_ecg_files([str(good), str(missing)])
+
+
+def test_gzip_input_matches_plain_parse(tmp_path):
+    import gzip
+
+    lines = ["Interval=0.004"]
+    lines += ["%.3f %.4f" % (i * 0.004, math.sin(i * 0.1)) for i in range(200)]
+    text = "\n".join(lines) + "\n"
+
+    plain = write_tmp(tmp_path, text)
+    gz = tmp_path / "ecg.txt.gz"
+    with gzip.open(gz, "wt", newline="\n") as f:
+        f.write(text)
+
+    t0, v0, fs0, meta0 = parse_ecg_file_cpp(str(plain), cache=False)
+    try:
+        t1, v1, fs1, meta1 = parse_ecg_file_cpp(str(gz), cache=False)
+    except RuntimeError as e:
+        if "zlib" in str(e):
+            pytest.skip("parser built without zlib")
+        raise
+
+    np.testing.assert_array_equal(t1, t0)
+    np.testing.assert_array_equal(v1, v0)
+    assert fs1 == fs0
+    assert meta1 == meta0
+
+
+def test_zstd_input_rejected_with_clear_error(tmp_path):
+    p = tmp_path / "ecg.txt.zst"
+    p.write_bytes(b"\x28\xb5\x2f\xfd" + b"\x00" * 16)
+
+    with pytest.raises(RuntimeError, match="zstd"):
+        parse_ecg_file_cpp(str(p), cache=False)